@@ -0,0 +1,346 @@
+// hotpath_bench.cpp
+// 排课核心热点路径基准，结果按 Google Benchmark 的 JSON 格式输出，便于跨版本对比：
+//   hotpath_bench [--profile course.json] [--sizes 1000,10000,100000]
+//                 [--min-time 0.5] [--seed 1] [--out results.json]
+// 输入为按 course.json 分布合成的课程目录（先修深度、班次数、上课时间均与真实数据一致）
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <ctime>
+#include <memory>
+#include "binarycatalog.h"
+#include "catalogsynth.h"
+#include "coursesearchindex.h"
+#include "jsonparser.h"
+#include "prereqclosure.h"
+#include "prereqgraph.h"
+#include "schedule.h"
+#include "schedulevalidator.h"
+#include "stringpool.h"
+
+// 阻止编译器把被测代码的结果优化掉
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+struct BenchResult {
+    QString name;
+    qint64 iterations = 0;
+    double realNs = 0;       // 每次迭代的墙钟时间
+    double cpuNs = 0;        // 每次迭代的进程 CPU 时间
+    qint64 items = 0;        // 每次迭代处理的元素数，用于计算吞吐量
+};
+
+// 预热一次后按倍增的迭代次数重复运行，直到总耗时不少于 minTime 秒
+template <typename Body>
+BenchResult measure(const QString& name, double minTime, qint64 items, Body&& body) {
+    body();
+    BenchResult r;
+    r.name = name;
+    r.items = items;
+    for (qint64 iters = 1;; iters *= 2) {
+        QElapsedTimer timer;
+        const std::clock_t cpu0 = std::clock();
+        timer.start();
+        for (qint64 i = 0; i < iters; ++i) body();
+        const qint64 ns = timer.nsecsElapsed();
+        const double cpuNs = double(std::clock() - cpu0) * 1e9 / CLOCKS_PER_SEC;
+        if (ns >= minTime * 1e9 || iters >= (qint64(1) << 30)) {
+            r.iterations = iters;
+            r.realNs = double(ns) / iters;
+            r.cpuNs = cpuNs / iters;
+            return r;
+        }
+    }
+}
+
+static QJsonObject toJson(const BenchResult& r) {
+    QJsonObject obj;
+    obj["name"] = r.name;
+    obj["run_type"] = "iteration";
+    obj["iterations"] = r.iterations;
+    obj["real_time"] = r.realNs;
+    obj["cpu_time"] = r.cpuNs;
+    obj["time_unit"] = "ns";
+    if (r.items > 0 && r.realNs > 0)
+        obj["items_per_second"] = r.items * 1e9 / r.realNs;
+    return obj;
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser cli;
+    cli.setApplicationDescription("排课核心热点路径基准");
+    cli.addHelpOption();
+    QCommandLineOption profileOpt("profile", "用于统计分布的真实课程文件", "file",
+                                  QCoreApplication::applicationDirPath() + "/data/course.json");
+    QCommandLineOption sizesOpt("sizes", "合成目录的课程数，逗号分隔", "list", "1000,10000,100000");
+    QCommandLineOption minTimeOpt("min-time", "每项基准的最短运行时间（秒）", "sec", "0.5");
+    QCommandLineOption seedOpt("seed", "合成目录的随机种子", "n", "1");
+    QCommandLineOption outOpt("out", "JSON 结果文件", "file");
+    cli.addOptions({profileOpt, sizesOpt, minTimeOpt, seedOpt, outOpt});
+    cli.process(app);
+
+    QTextStream out(stdout);
+    JsonParser parser;
+    const CourseCatalog real = parser.loadCourseCatalog(cli.value(profileOpt));
+    if (real.courseCount() == 0) {
+        out << "无法加载课程文件：" << cli.value(profileOpt) << Qt::endl;
+        return 1;
+    }
+    const CatalogProfile profile = CatalogProfile::fromCatalog(real);
+    const double minTime = cli.value(minTimeOpt).toDouble();
+    const quint32 seed = cli.value(seedOpt).toUInt();
+
+    QTemporaryDir tmp;
+    if (!tmp.isValid()) {
+        out << "无法创建临时目录" << Qt::endl;
+        return 1;
+    }
+
+    QList<BenchResult> results;
+    auto report = [&](const BenchResult& r) {
+        results.append(r);
+        out << QString("%1 %2 %3 %4")
+                   .arg(r.name, -40)
+                   .arg(QString::number(r.realNs, 'f', 0) + " ns", 16)
+                   .arg(QString::number(r.cpuNs, 'f', 0) + " ns", 16)
+                   .arg(r.iterations, 10) << Qt::endl;
+    };
+    out << QString("%1 %2 %3 %4").arg("benchmark", -40).arg("time", 16).arg("cpu", 16)
+               .arg("iterations", 10) << Qt::endl;
+
+    for (const QString& sizeStr : cli.value(sizesOpt).split(',', Qt::SkipEmptyParts)) {
+        const int n = sizeStr.toInt();
+        if (n <= 0) continue;
+        const QList<Course> courses = synthesizeCatalog(profile, n, seed);
+        const QString suffix = QString("/%1").arg(n);
+
+        const QString path = tmp.filePath(QString("course_%1.json").arg(n));
+        if (!parser.exportCourseJson(courses, path)) return 1;
+        report(measure("JsonParser::loadCourseCatalog" + suffix, minTime, n, [&] {
+            CourseCatalog loaded = parser.loadCourseCatalog(path);
+            doNotOptimize(loaded);
+        }));
+        report(measure("JsonParser::parseCourseJsonDom" + suffix, minTime, n, [&] {
+            QList<Course> parsed = parser.parseCourseJsonDom(path);
+            doNotOptimize(parsed);
+        }));
+        report(measure("JsonParser::parseCourseJsonStream(StringPool)" + suffix, minTime, n, [&] {
+            StringPool pool;
+            QList<Course> parsed = parser.parseCourseJsonStream(path, &pool);
+            doNotOptimize(parsed);
+        }));
+        QFile::remove(path);
+
+        // 预编译目录：打开（mmap + 校验）并直接建立 CourseCatalog
+        const QString binPath = tmp.filePath(QString("course_%1.cscat").arg(n));
+        if (!BinaryCatalog::write(courses, binPath)) return 1;
+        QString openError;
+        const BenchResult opened = measure("BinaryCatalog::open+CourseCatalog" + suffix, minTime, n, [&] {
+            auto binary = std::make_shared<BinaryCatalog>();
+            if (!binary->open(binPath)) {
+                openError = binary->errorString();
+                return;
+            }
+            CourseCatalog loaded(binary);
+            doNotOptimize(loaded);
+        });
+        if (!openError.isEmpty()) {
+            out << "无法打开课程目录：" << binPath << "（" << openError << "）" << Qt::endl;
+            return 1;
+        }
+        report(opened);
+        QFile::remove(binPath);
+
+        ScheduleManager mgr(courses);
+        for (int sem = 0; sem < 8; ++sem)
+            mgr.setCreditLimit(sem, 30);
+        mgr.setCreditTarget(1 << 30);   // 不让贪心提前停止
+
+        const ScheduleProblem problem = mgr.makeProblem();
+        const CourseCatalog& catalog = *problem.catalog;
+        report(measure("PrereqGraph::sort" + suffix, minTime, n, [&] {
+            PrereqGraph graph(catalog);
+            QVector<int> order;
+            graph.sort(order);
+            doNotOptimize(order);
+        }));
+        report(measure("PrereqClosure" + suffix, minTime, n, [&] {
+            PrereqClosure closure(*problem.graph);
+            doNotOptimize(closure);
+        }));
+        // 闭包上的依赖查询：每门课程问一次“是否以 0 号课程为（间接）先修”
+        report(measure("PrereqClosure::dependsOn" + suffix, minTime, n, [&] {
+            int hits = 0;
+            for (int c = 0; c < n; ++c)
+                hits += problem.closure->dependsOn(*problem.graph, c, 0);
+            doNotOptimize(hits);
+        }));
+        report(measure("ScheduleManager::topologicalSort" + suffix, minTime, n, [&] {
+            QList<QString> order = mgr.topologicalSort();
+            doNotOptimize(order);
+        }));
+        report(measure("ScheduleManager::generateSchedule" + suffix, minTime, n, [&] {
+            mgr.generateSchedule();
+        }));
+
+        // 增量排课与整体重排的对比：模拟界面上逐门选课 / 退课。
+        // 只有手动选中的课程参与排课（其余优先级为 0），在少量已选课程的课表上
+        // 反复加入再移除一门随机课程
+        {
+            ScheduleManager inc(courses);
+            for (int sem = 0; sem < 8; ++sem)
+                inc.setCreditLimit(sem, 30);
+            inc.setCreditTarget(160);
+            for (const auto& c : courses)
+                inc.setPriority(c.id, 0);
+            QRandomGenerator rng(seed);
+            QSet<QString> selected;
+            while (selected.size() < qMin(40, n))
+                selected.insert(courses[rng.bounded(n)].id);
+            QVector<QString> picks(64);
+            for (auto& id : picks)
+                id = courses[rng.bounded(n)].id;
+            inc.setSelectedCourses(selected);
+            inc.generateSchedule();
+
+            int next = 0;
+            report(measure("ScheduleManager::insertCourse+retractCourse" + suffix, minTime, 2, [&] {
+                const QString& id = picks[next++ % picks.size()];
+                inc.insertCourse(id);
+                inc.retractCourse(id);
+            }));
+            report(measure("ScheduleManager::generateSchedule(add+remove)" + suffix, minTime, 2, [&] {
+                const QString& id = picks[next++ % picks.size()];
+                QSet<QString> with = selected;
+                with.insert(id);
+                inc.setSelectedCourses(with);
+                inc.generateSchedule();
+                inc.setSelectedCourses(selected);
+                inc.generateSchedule();
+            }));
+
+            // 同一组已选课程上逐个取前 5 个备选方案（相互至少相差 2 门课程）
+            const ScheduleProblem incProblem = inc.makeProblem();
+            report(measure("ScheduleEnumerator::next(top5)" + suffix, minTime, 5, [&] {
+                ScheduleEnumerator enumerator(incProblem, 2);
+                enumerator.setTimeBudget(200);
+                ScheduleSolution alt;
+                for (int k = 0; k < 5 && enumerator.next(alt); ++k) {}
+                doNotOptimize(alt);
+            }));
+        }
+
+        // checkTimeConflicts 是私有函数，这里通过求解器使用的同一检查（学分 + 位图冲突）
+        // 对已排好的课表扫描所有 (班次, 学期) 组合
+        SolverState state(problem);
+        for (const auto& pl : mgr.getLastSolution().placements)
+            state.place(pl);
+        const int offerings = catalog.offeringCount();
+        report(measure("checkTimeConflicts" + suffix, minTime, qint64(offerings) * 8, [&] {
+            int free = 0;
+            for (int sem = 0; sem < 8; ++sem) {
+                for (int o = 0; o < offerings; ++o)
+                    free += state.canPlace(catalog.offeringCourse(o), o, sem);
+            }
+            doNotOptimize(free);
+        }));
+        // 同样的问题改由节次倒排位图回答（只看时间，不含学分检查）
+        report(measure("ScheduleManager::getFreeOfferings" + suffix, minTime, qint64(offerings) * 8, [&] {
+            qsizetype free = 0;
+            for (int sem = 0; sem < 8; ++sem)
+                free += mgr.getFreeOfferings(sem).size();
+            doNotOptimize(free);
+        }));
+        {
+            const QList<ScheduledCourse> scheduled = mgr.getAllScheduled();
+            const ScheduleValidator validator(catalog);
+            report(measure("ScheduleValidator::validate" + suffix, minTime, scheduled.size(), [&] {
+                ValidationResult r = validator.validate(scheduled);
+                doNotOptimize(r);
+            }));
+        }
+        report(measure("ScheduleManager::getCreditSum" + suffix, minTime, 8, [&] {
+            int sum = 0;
+            for (int sem = 0; sem < 8; ++sem)
+                sum += mgr.getCreditSum(sem);
+            doNotOptimize(sum);
+        }));
+        report(measure("CourseOffering::timeSlotsToString" + suffix, minTime, offerings, [&] {
+            qsizetype len = 0;
+            for (int o = 0; o < offerings; ++o)
+                len += catalog.offering(o).timeSlotsToString().size();
+            doNotOptimize(len);
+        }));
+
+        // 课程检索：界面每次按键执行一次；查询取自课程名称的 1~4 字子串
+        report(measure("CourseSearchIndex::build" + suffix, minTime, n, [&] {
+            CourseSearchIndex index(catalog);
+            doNotOptimize(index);
+        }));
+        {
+            const CourseSearchIndex index(catalog);
+            QRandomGenerator rng(seed);
+            QVector<QString> queries(64);
+            for (auto& q : queries) {
+                const QString name = courses[rng.bounded(n)].name;
+                const int len = qMin(int(name.size()), 1 + int(rng.bounded(4)));
+                q = name.mid(rng.bounded(int(name.size()) - len + 1), len);
+            }
+            int next = 0;
+            report(measure("CourseSearchIndex::search" + suffix, minTime, 1, [&] {
+                QVector<int> hits = index.search(queries[next++ % queries.size()]);
+                doNotOptimize(hits);
+            }));
+        }
+    }
+
+    if (cli.isSet(outOpt)) {
+        QJsonObject context;
+        context["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+        context["executable"] = QCoreApplication::applicationFilePath();
+        context["host_name"] = QSysInfo::machineHostName();
+        context["num_cpus"] = QThread::idealThreadCount();
+        context["cpu_architecture"] = QSysInfo::currentCpuArchitecture();
+#ifdef NDEBUG
+        context["library_build_type"] = "release";
+#else
+        context["library_build_type"] = "debug";
+#endif
+        context["profile"] = cli.value(profileOpt);
+        context["seed"] = qint64(seed);
+
+        QJsonArray benchmarks;
+        for (const auto& r : results)
+            benchmarks.append(toJson(r));
+        QJsonObject root;
+        root["context"] = context;
+        root["benchmarks"] = benchmarks;
+
+        QFile file(cli.value(outOpt));
+        if (!file.open(QIODevice::WriteOnly)) {
+            out << "无法写入结果文件：" << file.fileName() << Qt::endl;
+            return 1;
+        }
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    }
+    return 0;
+}
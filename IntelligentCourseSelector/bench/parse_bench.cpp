@@ -0,0 +1,182 @@
+// parse_bench.cpp
+// 对比课程文件的三种解析方式：QJsonDocument DOM（parseCourseJsonDom）、流式 SAX
+// （parseCourseJsonStream）以及字符串驻留在 StringPool 中的流式 SAX
+//   parse_bench course.json [--repeat 3]
+// 每种方式在独立子进程中运行，互不影响峰值内存；子进程用 --mode dom|stream|pooled 启动，
+// 输出一行 JSON 结果（含首次解析的堆分配次数）。大文件可先用 coursesel_gen 生成
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTextStream>
+#include <atomic>
+#include "jsonparser.h"
+#include "stringpool.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// 堆分配次数：glibc 下在本程序中替换 malloc 系列（Qt 容器与 operator new 都经由它们），
+// 计数后转发给 glibc 的实现；其他平台不统计，结果为 -1
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* p, size_t size);
+}
+
+static std::atomic<qint64> allocations{0};
+
+extern "C" void* malloc(size_t size) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+extern "C" void* calloc(size_t n, size_t size) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+extern "C" void* realloc(void* p, size_t size) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+
+static qint64 allocationCount() { return allocations.load(); }
+#else
+static qint64 allocationCount() { return -1; }
+#endif
+
+// 进程峰值常驻内存（KB）
+static qint64 peakRssKb() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return qint64(pmc.PeakWorkingSetSize / 1024);
+    return -1;
+#else
+    rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return -1;
+#if defined(Q_OS_MACOS)
+    return ru.ru_maxrss / 1024;   // macOS 以字节为单位
+#else
+    return ru.ru_maxrss;
+#endif
+#endif
+}
+
+// 子进程：只跑一种解析方式，第一次的峰值内存即该方式的内存开销，耗时取多次中的最小值
+static int runChild(const QString& path, const QString& mode, int repeat) {
+    JsonParser parser;
+    const qint64 baseline = peakRssKb();
+    qint64 bestMs = -1;
+    qint64 peak = 0;
+    qint64 allocs = -1;
+    int count = 0;
+    int unique = 0;
+    qint64 arena = 0;
+    for (int i = 0; i < repeat; ++i) {
+        StringPool pool;   // 先于课程构造、后于课程析构
+        const qint64 allocs0 = allocationCount();
+        QElapsedTimer timer;
+        timer.start();
+        const QList<Course> courses = mode == "dom"      ? parser.parseCourseJsonDom(path)
+                                      : mode == "pooled" ? parser.parseCourseJsonStream(path, &pool)
+                                                         : parser.parseCourseJsonStream(path);
+        const qint64 ms = timer.elapsed();
+        if (i == 0) {
+            peak = peakRssKb();
+            if (allocs0 >= 0) allocs = allocationCount() - allocs0;
+        }
+        if (bestMs < 0 || ms < bestMs) bestMs = ms;
+        count = courses.size();
+        unique = pool.size();
+        arena = pool.arenaBytes();
+    }
+
+    QJsonObject obj;
+    obj["mode"] = mode;
+    obj["courses"] = count;
+    obj["ms"] = bestMs;
+    obj["baseline_kb"] = baseline;
+    obj["peak_kb"] = peak;
+    obj["allocs"] = allocs;
+    if (mode == "pooled") {
+        obj["unique_strings"] = unique;
+        obj["arena_kb"] = arena / 1024;
+    }
+    QTextStream(stdout) << QJsonDocument(obj).toJson(QJsonDocument::Compact) << Qt::endl;
+    return count > 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser cli;
+    cli.setApplicationDescription("课程文件解析基准：流式 SAX 与 DOM");
+    cli.addHelpOption();
+    cli.addPositionalArgument("file", "课程 JSON 文件");
+    QCommandLineOption modeOpt("mode", "只运行一种方式（dom、stream 或 pooled），供子进程使用", "mode");
+    QCommandLineOption repeatOpt("repeat", "重复次数，耗时取最小值", "n", "3");
+    cli.addOptions({modeOpt, repeatOpt});
+    cli.process(app);
+
+    QTextStream out(stdout);
+    const QStringList args = cli.positionalArguments();
+    if (args.isEmpty()) {
+        out << "用法：parse_bench course.json [--repeat n]" << Qt::endl;
+        return 1;
+    }
+    const QString path = args.first();
+    const int repeat = qMax(1, cli.value(repeatOpt).toInt());
+    if (cli.isSet(modeOpt))
+        return runChild(path, cli.value(modeOpt), repeat);
+
+    out << "文件：" << path << "（" << QString::number(QFileInfo(path).size() / 1048576.0, 'f', 1)
+        << " MB）" << Qt::endl;
+    out << QString("%1 %2 %3 %4 %5").arg("mode", -8).arg("courses", 10).arg("time(ms)", 10)
+               .arg("peak(MB)", 10).arg("allocs", 12) << Qt::endl;
+
+    QHash<QString, QJsonObject> results;
+    for (const QString& mode : {QString("dom"), QString("stream"), QString("pooled")}) {
+        QProcess child;
+        child.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        child.start(QCoreApplication::applicationFilePath(),
+                    {path, "--mode", mode, "--repeat", QString::number(repeat)});
+        if (!child.waitForFinished(-1) || child.exitCode() != 0) {
+            out << mode << " 解析失败" << Qt::endl;
+            return 1;
+        }
+        const QJsonObject r = QJsonDocument::fromJson(child.readAllStandardOutput()).object();
+        results.insert(mode, r);
+        const double peakMb = (r["peak_kb"].toInteger() - r["baseline_kb"].toInteger()) / 1024.0;
+        out << QString("%1 %2 %3 %4 %5").arg(mode, -8).arg(r["courses"].toInt(), 10)
+                   .arg(r["ms"].toInteger(), 10).arg(QString::number(peakMb, 'f', 1), 10)
+                   .arg(r["allocs"].toInteger(), 12)
+            << Qt::endl;
+    }
+
+    const QJsonObject dom = results.value("dom");
+    const QJsonObject stream = results.value("stream");
+    const qint64 domMem = dom["peak_kb"].toInteger() - dom["baseline_kb"].toInteger();
+    const qint64 streamMem = stream["peak_kb"].toInteger() - stream["baseline_kb"].toInteger();
+    out << "流式解析：耗时为 DOM 的 "
+        << QString::number(100.0 * stream["ms"].toInteger() / qMax<qint64>(1, dom["ms"].toInteger()), 'f', 1)
+        << "%，峰值内存为 DOM 的 "
+        << QString::number(100.0 * streamMem / qMax<qint64>(1, domMem), 'f', 1) << "%" << Qt::endl;
+
+    // 字符串池相对普通流式解析：分配次数与峰值内存
+    const QJsonObject pooled = results.value("pooled");
+    const qint64 pooledMem = pooled["peak_kb"].toInteger() - pooled["baseline_kb"].toInteger();
+    out << "字符串池：" << pooled["unique_strings"].toInt() << " 个不同字符串，arena "
+        << QString::number(pooled["arena_kb"].toInteger() / 1024.0, 'f', 1) << " MB；分配次数为流式解析的 "
+        << QString::number(100.0 * pooled["allocs"].toInteger() / qMax<qint64>(1, stream["allocs"].toInteger()), 'f', 1)
+        << "%，峰值内存为流式解析的 "
+        << QString::number(100.0 * pooledMem / qMax<qint64>(1, streamMem), 'f', 1) << "%" << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,88 @@
+// solver_bench.cpp
+// 对比贪心、分支定界、并行分支定界与局部搜索四种排课策略，并输出局部搜索的改进曲线：
+//   solver_bench [course.json] [放大倍数=100] [时间预算ms=5000] [每学期学分上限=30] [线程数=全部核心]
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <memory>
+#include "jsonparser.h"
+#include "schedule.h"
+
+// 把课程目录复制 factor 份，副本的课程ID与先修ID追加 "#k" 后缀
+static QList<Course> scaleCatalog(const CourseCatalog& base, int factor) {
+    QList<Course> out;
+    out.reserve(base.courseCount() * factor);
+    for (int k = 0; k < factor; ++k) {
+        const QString suffix = k == 0 ? QString() : QString("#%1").arg(k);
+        for (int i = 0; i < base.courseCount(); ++i) {
+            Course c = base.course(i);
+            c.id += suffix;
+            for (auto& pre : c.prerequisites) pre += suffix;
+            out.append(c);
+        }
+    }
+    return out;
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const QString path = args.value(1, QCoreApplication::applicationDirPath() + "/data/course.json");
+    const int factor = args.value(2, "100").toInt();
+    const int budgetMs = args.value(3, "5000").toInt();
+    const int semLimit = args.value(4, "30").toInt();
+    const int threads = args.value(5, "0").toInt();
+
+    QTextStream out(stdout);
+    JsonParser parser;
+    const CourseCatalog base = parser.loadCourseCatalog(path);
+    if (base.courseCount() == 0) {
+        out << "无法加载课程文件：" << path << Qt::endl;
+        return 1;
+    }
+    const QList<Course> courses = scaleCatalog(base, qMax(1, factor));
+
+    ScheduleManager mgr(courses);
+    for (int sem = 0; sem < 8; ++sem)
+        mgr.setCreditLimit(sem, semLimit);
+    mgr.setCreditTarget(1 << 30);   // 不让贪心提前停止
+
+    out << "课程数：" << courses.size() << "  时间预算：" << budgetMs << " ms"
+        << "  学期学分上限：" << semLimit << Qt::endl;
+    out << QString("%1 %2 %3 %4 %5 %6 %7")
+               .arg("solver", -18).arg("score", 10).arg("credits", 8).arg("courses", 8)
+               .arg("time(ms)", 10).arg("nodes", 12).arg("optimal", 8) << Qt::endl;
+
+    auto run = [&](std::unique_ptr<ScheduleSolver> solver) {
+        const QString name = solver->name();
+        mgr.setSolver(std::move(solver));
+        QElapsedTimer timer;
+        timer.start();
+        mgr.generateSchedule();
+        const qint64 ms = timer.elapsed();
+        const ScheduleSolution& s = mgr.getLastSolution();
+        out << QString("%1 %2 %3 %4 %5 %6 %7")
+                   .arg(name, -18).arg(s.score, 10).arg(s.credits, 8).arg(s.placements.size(), 8)
+                   .arg(ms, 10).arg(s.nodes, 12).arg(s.optimal ? "yes" : "no", 8) << Qt::endl;
+        return s.score;
+    };
+
+    const qint64 greedy = run(std::unique_ptr<ScheduleSolver>(new GreedySolver));
+    const qint64 exact = run(std::unique_ptr<ScheduleSolver>(new BranchBoundSolver(budgetMs)));
+    run(std::unique_ptr<ScheduleSolver>(new ParallelBranchBoundSolver(threads, budgetMs)));
+    // run 之后求解器归 mgr 所有，改进曲线通过 mgr.getSolver() 读取
+    const qint64 local = run(std::unique_ptr<ScheduleSolver>(new LocalSearchSolver(budgetMs)));
+    if (greedy > 0) {
+        out << QString("分支定界相对贪心提升：%1%").arg(100.0 * (exact - greedy) / greedy, 0, 'f', 2)
+            << Qt::endl;
+        out << QString("局部搜索相对贪心提升：%1%").arg(100.0 * (local - greedy) / greedy, 0, 'f', 2)
+            << Qt::endl;
+    }
+
+    const auto* ls = static_cast<const LocalSearchSolver*>(mgr.getSolver());
+    out << "局部搜索改进曲线：" << Qt::endl;
+    out << QString("%1 %2 %3").arg("time(ms)", 10).arg("score", 10).arg("moves", 12) << Qt::endl;
+    for (const ImprovementPoint& pt : ls->improvements())
+        out << QString("%1 %2 %3").arg(pt.ms, 10).arg(pt.score, 10).arg(pt.moves, 12) << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,65 @@
+#ifndef BATCHPLANNER_H
+#define BATCHPLANNER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include "schedule.h"
+
+// 单个学生的排课请求（JSONL 中的一行）
+struct PlanRequest {
+    struct Blocked {
+        int semester;
+        int day;
+        quint32 mask;
+    };
+
+    QString studentId;
+    QSet<QString> selected;
+    QHash<QString, int> priorities;   // 未给出的课程使用默认优先级 5
+    QList<Blocked> blocked;
+    QVector<int> creditLimits;        // 为空时使用默认学期上限
+    int creditTarget = 0;             // 与界面一致：总学分达到该值后贪心不再排入未选中的课程
+    int creditCap = 0;                // 分支定界与局部搜索的总学分上限，0 表示不限
+};
+
+// 单个学生的排课结果
+struct PlanResult {
+    QString studentId;
+    QList<ScheduledCourse> schedule;
+    qint64 score = 0;
+    int credits = 0;
+    bool optimal = false;
+    QString error;                    // 非空表示该请求无法处理
+};
+
+// 批量排课：所有学生共享同一份课程目录与先修图（base 须在使用期间保持有效），
+// 每个请求只复制优先级、限制等少量输入，在线程池中并行求解
+class BatchPlanner {
+public:
+    enum class Engine { Greedy, BranchBound, LocalSearch };
+
+    explicit BatchPlanner(const ScheduleManager& base);
+
+    void setEngine(Engine e) { engine = e; }
+    void setTimeBudget(int ms) { budgetMs = ms; }
+    void setThreadCount(int n) { threads = n; }
+
+    PlanResult plan(const PlanRequest& request) const;
+    QVector<PlanResult> run(const QVector<PlanRequest>& requests) const;
+
+    // 解析一行学生请求，序列化一条结果（均为单行 JSON，结果中的课表与 schedule.json 格式相同）
+    static bool parseRequest(const QByteArray& line, PlanRequest& out);
+    static QByteArray resultToJson(const PlanResult& result);
+
+private:
+    ScheduleProblem baseProblem;
+    Engine engine = Engine::Greedy;
+    int budgetMs = 200;
+    int threads = 0;                  // 0 表示使用全部核心
+};
+
+#endif // BATCHPLANNER_H
@@ -0,0 +1,133 @@
+#ifndef BINARYCATALOG_H
+#define BINARYCATALOG_H
+
+#include <QString>
+#include <QList>
+#include <QFile>
+#include "course.h"
+
+// 预编译的二进制课程目录（.cscat），由 course.json 编译而来，通过 mmap 零拷贝打开。
+// 文件布局（小端，各段 8 字节对齐）：
+//   Header | CourseRecord[courseCount] | OfferingRecord[offeringCount]
+//          | PrereqRecord[prereqCount] | 字符串表（UTF-16，重复字符串只存一份）
+// 课程的班次与先修课各占一段连续区间，先修区间即预先建好的 CSR 邻接表。
+// Header 记录编译时来源 JSON 的大小与修改时间，据此判断目录是否过期。
+// Header 自带校验和，打开时只校验它；覆盖整个文件的校验和按需检查（FullCheck）
+class BinaryCatalog {
+public:
+    static constexpr quint32 Version = 3;
+
+    enum Check {
+        HeaderCheck,   // 校验 Header 与各段区间，字符串表不会被读入
+        FullCheck      // 另外计算全文件校验和，coursesel_compile 写出后使用
+    };
+
+    // 来源 JSON 的大小（字节）与修改时间（毫秒时间戳），未知时均为 -1
+    struct Source {
+        qint64 size;
+        qint64 modifiedMs;
+
+        bool operator==(const Source& o) const { return size == o.size && modifiedMs == o.modifiedMs; }
+        bool operator!=(const Source& o) const { return !(*this == o); }
+    };
+
+    // 字符串表中的一段，单位为 UTF-16 码元
+    struct StrRef {
+        quint32 offset;
+        quint32 length;
+    };
+    struct Header {
+        char magic[8];           // "CSCATLG\0"
+        quint32 version;
+        quint32 byteOrder;       // 0x01020304，用于拒绝字节序不同的文件
+        quint32 courseCount;
+        quint32 offeringCount;
+        quint32 prereqCount;
+        quint32 stringUnits;
+        quint64 coursesOffset;
+        quint64 offeringsOffset;
+        quint64 prereqsOffset;
+        quint64 stringsOffset;
+        qint64 sourceSize;       // 来源 JSON，见 Source
+        qint64 sourceModified;
+        quint32 checksum;        // Header 之后全部字节的 CRC-32
+        quint32 headerChecksum;  // 本字段之前 Header 各字节的 CRC-32
+    };
+    struct CourseRecord {
+        StrRef id;
+        StrRef name;
+        StrRef required;
+        qint32 credit;
+        quint32 offeringBegin;
+        quint32 offeringEnd;
+        quint32 prereqBegin;
+        quint32 prereqEnd;
+    };
+    struct OfferingRecord {
+        StrRef id;
+        StrRef teacher;
+        quint32 times[7];
+        quint32 weeks;
+        quint32 course;
+    };
+    struct PrereqRecord {
+        StrRef id;
+        qint32 course;           // 先修课程下标，目录中不存在时为 -1
+    };
+
+    BinaryCatalog() = default;
+    ~BinaryCatalog();
+    BinaryCatalog(const BinaryCatalog&) = delete;
+    BinaryCatalog& operator=(const BinaryCatalog&) = delete;
+
+    // 打开并校验文件（版本、Header 校验和、段长度与记录区间），失败时 errorString() 给出原因。
+    // 记录各段随后会被 CourseCatalog 整体读取，逐条检查不增加额外的缺页；
+    // 字符串表只在访问时才换入，除非 check 为 FullCheck
+    bool open(const QString& filePath, Check check = HeaderCheck);
+    // 计算全文件校验和并与 Header 比较，不一致时关闭目录并返回 false
+    bool verifyChecksum();
+    void close();
+    bool isOpen() const { return header != nullptr; }
+    QString errorString() const { return error; }
+
+    // 把课程列表编译为二进制目录；source 为课程列表的来源 JSON，应在解析之前取得
+    static bool write(const QList<Course>& courses, const QString& filePath,
+                      const Source& source = Source{-1, -1});
+    // 文件当前的大小与修改时间；文件不存在时返回未知
+    static Source sourceOf(const QString& jsonPath);
+
+    int courseCount() const { return int(header->courseCount); }
+    int offeringCount() const { return int(header->offeringCount); }
+    int prereqCount() const { return int(header->prereqCount); }
+    Source source() const { return Source{header->sourceSize, header->sourceModified}; }
+
+    const CourseRecord& courseRecord(int course) const { return courses[course]; }
+    const OfferingRecord& offeringRecord(int offering) const { return offerings[offering]; }
+    const PrereqRecord& prereqRecord(int index) const { return prereqs[index]; }
+
+    // 返回直接引用映射内存的 QString（不分配、不拷贝），有效期与本对象相同
+    QString string(const StrRef& ref) const {
+        return QString::fromRawData(strings + ref.offset, qsizetype(ref.length));
+    }
+
+    // 物化为普通的 Course / CourseOffering（深拷贝字符串，仅在需要完整对象时使用）
+    Course toCourse(int course) const;
+    CourseOffering toOffering(int offering) const;
+    QList<Course> toCourses() const;
+
+private:
+    bool fail(const QString& message);
+    bool validate(qint64 fileSize);
+    QString copy(const StrRef& ref) const;
+
+    QFile file;
+    const uchar* base = nullptr;
+    const Header* header = nullptr;
+    const CourseRecord* courses = nullptr;
+    const OfferingRecord* offerings = nullptr;
+    const PrereqRecord* prereqs = nullptr;
+    const QChar* strings = nullptr;
+    QString error;
+};
+
+#endif // BINARYCATALOG_H
@@ -0,0 +1,102 @@
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QVector>
+#include <memory>
+#include "course.h"
+#include "slotmask.h"
+
+class BinaryCatalog;
+class StringPool;
+
+// 邻接表中一段连续下标
+struct IndexRange {
+    const int* first = nullptr;
+    const int* last = nullptr;
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    int size() const { return int(last - first); }
+    bool isEmpty() const { return first == last; }
+};
+
+// 课程目录：把课程与班次的 QString ID 驻留为稠密整数下标
+// 课程下标 c ∈ [0, courseCount())，班次下标 o ∈ [0, offeringCount())，
+// 课程 c 的班次占据 [offeringBegin(c), offeringEnd(c)) 这一连续区间。
+// 按列存储：学分、必修标记、班次时间位图、周次、班次 -> 课程等热数据各占一个连续数组，
+// 字符串单独成列，排课循环扫描时不会把字符串头带进缓存。Course / CourseOffering
+// 只在界面与导出时按需由各列物化。
+// 可由课程列表构建，也可直接建在内存映射的 BinaryCatalog 上（字符串不拷贝）
+class CourseCatalog {
+public:
+    CourseCatalog() = default;
+    // pool 为解析 courses 时使用的字符串池（若有），由目录持有以保证字符串有效；
+    // 此时与二进制目录一样，返回的字符串引用池内存，有效期与目录相同
+    explicit CourseCatalog(const QList<Course>& courses, std::shared_ptr<const StringPool> pool = nullptr);
+    explicit CourseCatalog(std::shared_ptr<const BinaryCatalog> binary);
+
+    int courseCount() const { return credits.size(); }
+    int offeringCount() const { return offeringToCourse.size(); }
+
+    // ID -> 下标，未找到返回 -1
+    int courseIndex(const QString& courseId) const;
+    int offeringIndex(int course, const QString& offeringId) const;
+
+    // 下标 -> ID（仅用于 UI / JSON 边界）
+    QString courseId(int course) const;
+    QString offeringId(int offering) const;
+    QString courseName(int course) const;
+    QString courseRequired(int course) const;   // "Compulsory" 或 "Elective"
+    QString offeringTeacher(int offering) const;
+    QStringList prerequisiteIds(int course) const;   // 原始先修课程ID，含目录中不存在的
+
+    // 完整的课程 / 班次对象，每次调用都由各列物化，不要在热循环中使用
+    Course course(int course) const;
+    CourseOffering offering(int offering) const;
+
+    int credit(int course) const { return credits[course]; }
+    bool isCompulsory(int course) const { return compulsory[course]; }
+    int offeringBegin(int course) const { return offeringStart[course]; }
+    int offeringEnd(int course) const { return offeringStart[course + 1]; }
+    int offeringCourse(int offering) const { return offeringToCourse[offering]; }
+    const SlotMask& offeringMask(int offering) const { return offeringMasks[offering]; }
+    quint32 offeringWeeks(int offering) const { return offeringWeekMasks[offering]; }
+    IndexRange prerequisites(int course) const {
+        const int* base = prereqList.constData();
+        return IndexRange{base + prereqStart[course], base + prereqStart[course + 1]};
+    }
+    // 存在目录中找不到的先修课程时，该课程永远无法满足先修条件
+    bool hasUnresolvedPrerequisite(int course) const { return unresolved[course]; }
+
+private:
+    // 字符串列，只在界面 / JSON 边界访问（由课程列表构建时使用）
+    struct StringColumns {
+        QVector<QString> courseIds;
+        QVector<QString> names;
+        QVector<QString> required;
+        QVector<QString> offeringIds;
+        QVector<QString> teachers;
+        QVector<int> prereqIdStart;     // 课程下标 -> 原始先修ID区间起点（长度 n+1）
+        QVector<QString> prereqIds;
+    };
+
+    void addPrerequisite(int course, const QString& pre, int resolved);
+
+    StringColumns text;                           // 由课程列表构建时使用
+    std::shared_ptr<const StringPool> pool;       // text 引用的字符串池（若有）
+    std::shared_ptr<const BinaryCatalog> binary;  // 由二进制目录构建时使用
+    QHash<QString, int> idToCourse;     // 课程ID -> 课程下标
+    QVector<int> credits;               // 课程下标 -> 学分
+    QVector<bool> compulsory;           // 课程下标 -> 是否必修
+    QVector<int> offeringStart;         // 课程下标 -> 首个班次下标（长度 n+1）
+    QVector<int> offeringToCourse;      // 班次下标 -> 课程下标
+    QVector<SlotMask> offeringMasks;    // 班次下标 -> 打包后的上课时间
+    QVector<quint32> offeringWeekMasks; // 班次下标 -> 上课周
+    QVector<int> prereqStart;           // 课程下标 -> 先修区间起点（长度 n+1）
+    QVector<int> prereqList;            // 已解析的先修课程下标
+    QVector<bool> unresolved;           // 课程下标 -> 是否引用了未知先修课程
+};
+
+#endif // CATALOG_H
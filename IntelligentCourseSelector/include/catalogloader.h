@@ -0,0 +1,45 @@
+#ifndef CATALOGLOADER_H
+#define CATALOGLOADER_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include "course.h"
+#include "coursesearchindex.h"
+#include "schedule.h"
+
+class QThread;
+
+// 在后台线程加载课程目录：有最新的二进制目录时直接映射，否则流式解析 JSON，
+// 每解析出 ChunkSize 门课程发出一次 coursesLoaded，界面可以边解析边显示。
+// 课程全部到齐后在同一线程建好目录与先修图（即 ScheduleManager）以及检索索引，再发出 finished
+class CatalogLoader : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int ChunkSize = 2000;
+
+    explicit CatalogLoader(const QString& filePath, QObject* parent = nullptr);
+    ~CatalogLoader() override;   // 中止解析并等待加载线程结束
+
+    void start();
+    // finished 之后取走建好的排课器；加载失败时为空目录上的排课器
+    std::unique_ptr<ScheduleManager> takeManager();
+    CourseSearchIndex takeSearchIndex();
+
+signals:
+    void coursesLoaded(const QList<Course>& chunk);
+    void finished(bool ok);
+
+private:
+    void run();
+
+    QString path;
+    QThread* thread = nullptr;
+    std::atomic<bool> abortRequested{false};
+    std::unique_ptr<ScheduleManager> manager;   // 以下由加载线程写入，finished 之后才可读取
+    CourseSearchIndex searchIndex;
+};
+
+#endif // CATALOGLOADER_H
@@ -0,0 +1,38 @@
+#ifndef CATALOGSYNTH_H
+#define CATALOGSYNTH_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include "course.h"
+
+class CourseCatalog;
+
+// 真实课程目录的经验分布，合成时按这些样本池有放回抽样
+struct CatalogProfile {
+    QVector<int> credits;            // 每门课的学分
+    QVector<int> offeringCounts;     // 每门课的班次数
+    QVector<int> depths;             // 每门课的最长先修链深度（无先修为 0）
+    QVector<int> prereqCounts;       // 有先修课程的课程的直接先修数
+    QVector<int> activeDays;         // 每个班次的上课天数
+    QVector<int> days;               // 所有班次上课日（0-6）
+    QVector<quint32> dayMasks;       // 所有非零的单日节次掩码
+    QVector<quint32> weekMasks;      // 每个班次的上课周掩码
+    QStringList idPrefixes;          // 课程ID的字母前缀，如 "COEN"
+    QStringList names;
+    double compulsoryRatio = 0.0;    // "Compulsory" 课程占比
+    double teachersPerOffering = 1.0;
+
+    bool isEmpty() const { return credits.isEmpty(); }
+    int maxDepth() const;
+
+    static CatalogProfile fromCatalog(const CourseCatalog& catalog);
+    static CatalogProfile fromCourses(const QList<Course>& courses);
+};
+
+// 按 profile 生成 count 门课程，同一 seed 产生完全相同的目录；
+// 先修关系只指向更浅层的课程，因此结果总是无环的
+QList<Course> synthesizeCatalog(const CatalogProfile& profile, int count, quint32 seed);
+
+#endif // CATALOGSYNTH_H
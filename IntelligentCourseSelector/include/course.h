@@ -10,8 +10,12 @@ struct CourseOffering {
     QString id;
     QString teacher;
     quint32 times[7];
+    quint32 weeks = AllWeeks;   // 第 k 位表示第 k+1 周上课，course.json 中缺省时视为每周都上
+
+    static constexpr quint32 AllWeeks = 0xFFFFFFFFu;
 
     QString timeSlotsToString() const;
+    QString weeksToString() const;   // 如 "第1-9周"、"第2,4,6周"
 };
 
 // 课程信息
@@ -0,0 +1,34 @@
+#ifndef COURSESEARCHINDEX_H
+#define COURSESEARCHINDEX_H
+
+#include <QString>
+#include <QVector>
+#include "catalog.h"
+
+// 课程全文检索：对课程名称、课程ID与各班次教师建立一元 / 二元字符（UTF-16 码元）倒排索引，
+// 加载时构建一次。查询按空白分成多个关键词，返回每个关键词都是某一字段子串的课程；
+// 不区分大小写，中文按字处理，无需分词。
+// 倒排表按 n-gram 排序后以 CSR 存储：grams[k] 的课程下标为 postings[start[k], start[k+1])
+class CourseSearchIndex {
+public:
+    CourseSearchIndex() = default;
+    explicit CourseSearchIndex(const CourseCatalog& catalog);
+
+    int courseCount() const { return texts.size(); }
+    // 匹配的课程下标（升序）；查询为空时返回空
+    QVector<int> search(const QString& query) const;
+
+private:
+    // 一元 gram 为码元本身（高 16 位为 0），二元 gram 为 (前一码元 << 16) | 后一码元
+    static quint32 gram(QChar a) { return a.unicode(); }
+    static quint32 gram(QChar a, QChar b) { return (quint32(a.unicode()) << 16) | b.unicode(); }
+    IndexRange postingsOf(quint32 g) const;
+    void matchTerm(const QString& term, QVector<int>& result, bool first) const;
+
+    QVector<QString> texts;    // 课程下标 -> 折叠大小写后的 "名称\n课程ID\n教师..."，用于校验候选
+    QVector<quint32> grams;    // 升序
+    QVector<int> start;        // 长度 grams.size() + 1
+    QVector<int> postings;
+};
+
+#endif // COURSESEARCHINDEX_H
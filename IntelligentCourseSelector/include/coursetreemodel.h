@@ -0,0 +1,59 @@
+#ifndef COURSETREEMODEL_H
+#define COURSETREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QList>
+#include <QPair>
+#include <QVector>
+#include "catalog.h"
+
+// 课程浏览树的模型：两个分类节点（必修 / 选修）下挂全部课程。
+// 直接读 CourseCatalog，不为课程创建任何条目对象；显示文本、提示与详情
+// 都在 data() / details() 中按需生成，只有视图可见的行才会被格式化。
+// 启动时目录尚未建好，可先用 appendCourses 按解析顺序逐批显示课程，目录就绪后再 setCatalog
+class CourseTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+public:
+    enum Role {
+        CourseIdRole = Qt::UserRole,    // 课程ID，分类节点为空
+        CourseIndexRole                 // 课程在目录中的下标，分类节点为 -1
+    };
+
+    // catalog 须在模型的生命周期内有效，为空时模型从空白开始
+    explicit CourseTreeModel(const CourseCatalog* catalog = nullptr, QObject* parent = nullptr);
+
+    // 追加一批尚未进入目录的课程（插入行，不重置视图）
+    void appendCourses(const QList<Course>& chunk);
+    // 切换到目录。目录与已追加的课程按相同顺序一一对应时只替换数据源，
+    // 否则重置模型（同时取消过滤）
+    void setCatalog(const CourseCatalog* catalog);
+
+    // 只显示给定的课程（下标升序，如 CourseSearchIndex::search 的结果）；过滤期间不再追加课程
+    void setFilter(const QVector<int>& courses);
+    void clearFilter();
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    // index 对应的课程下标，分类节点或无效索引返回 -1
+    int courseAt(const QModelIndex& index) const;
+    // 课程详情（属性, 值），供详情表使用
+    QList<QPair<QString, QString>> details(const QModelIndex& index) const;
+
+private:
+    void rebuildGroups();
+
+    // 顶层节点的 internalId 为 0，课程节点为所属分类下标 + 1
+    const CourseCatalog* catalog;
+    QList<Course> staged;       // 目录就绪前逐批追加的课程，下标与目录一致
+    QVector<quint8> groupOf;    // 课程下标 -> 分类
+    QVector<int> groups[2];     // 分类 -> 当前显示的课程下标（必修、选修）
+    bool filtered = false;
+};
+
+#endif // COURSETREEMODEL_H
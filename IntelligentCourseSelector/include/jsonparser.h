@@ -3,17 +3,48 @@
 
 #include <QString>
 #include <QList>
+#include <QByteArray>
 #include <QJsonArray>
+#include <functional>
+#include <memory>
+#include "catalog.h"
 #include "course.h"
 #include "schedule.h"  // ✅ 必须包含 ScheduledCourse 定义
 
+class BinaryCatalog;
+class StringPool;
+
 class JsonParser {
 public:
-    // 从 JSON 文件中解析课程列表
+    // 加载课程目录：同名 .cscat 由当前 JSON 编译而来时直接建在内存映射上（不拷贝记录），
+    // 否则流式解析 JSON，字符串驻留在由目录持有的 StringPool 中。解析失败时目录为空
+    CourseCatalog loadCourseCatalog(const QString& filePath);
+    // 兼容接口：同上，但把目录物化为课程列表，二进制目录中的每条记录与字符串都会被拷贝出来。
+    // 只供确实需要可修改 QList<Course> 的调用方使用，加载目录请用 loadCourseCatalog
     QList<Course> parseCourseJson(const QString& filePath);
+    // 流式解析 JSON，不构建中间 DOM；单条记录格式错误时通过 handleJsonError 报告并跳过。
+    // 给出 pool 时所有字符串都驻留在池中（去重、不逐个分配），其有效期与池相同，
+    // 通常随后把池交给由这些课程建立的 CourseCatalog
+    QList<Course> parseCourseJsonStream(const QString& filePath, StringPool* pool = nullptr);
+    // 同上，但每解析出 chunkSize 门课程（0 表示不分批）就交给 onChunk，剩余部分在最后交出；
+    // onChunk 返回 false 时中止解析。文件完整解析时返回 true
+    bool parseCourseJsonStream(const QString& filePath, int chunkSize,
+                               const std::function<bool(const QList<Course>&)>& onChunk,
+                               StringPool* pool = nullptr);
+    // 旧的 QJsonDocument 整体解析，保留作对照基准
+    QList<Course> parseCourseJsonDom(const QString& filePath);
+
+    // course.json 对应的二进制目录路径（同目录同名，扩展名 .cscat）
+    static QString binaryCatalogPath(const QString& jsonPath);
+    // 打开 JSON 对应的二进制目录；不存在、已过期（JSON 的大小或修改时间与编译时不同）或校验失败时返回空
+    std::shared_ptr<const BinaryCatalog> openBinaryCatalog(const QString& jsonPath);
+
+    // 导出课程列表为 JSON 文件（与 course.json 格式相同）
+    bool exportCourseJson(const QList<Course>& courses, const QString& filePath);
 
     // 导出排课结果为 JSON 文件
     bool exportScheduleJson(const QList<ScheduledCourse>& schedule, const QString& filePath);
+    QJsonArray scheduleToJson(const QList<ScheduledCourse>& schedule) const;
 
 private:
     // 班次解析
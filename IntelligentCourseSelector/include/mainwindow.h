@@ -3,24 +3,35 @@
 
 #include <QMainWindow>
 #include <QTabWidget>
-#include <QTreeWidget>
+#include <QTreeView>
+#include <QLineEdit>
 #include <QTableWidget>
 #include <QPushButton>
 #include <QLabel>
 #include <QSpinBox>
 #include <QComboBox>
 #include <QList>
+#include <QElapsedTimer>
+#include <QPointer>
 
+#include "catalogloader.h"
+#include "coursesearchindex.h"
+#include "coursetreemodel.h"
 #include "jsonparser.h"
 #include "schedule.h"
+#include "schedulejob.h"
+#include "timetableview.h"
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
 public:
     MainWindow(QWidget* parent = nullptr);
 
+protected:
+    bool event(QEvent* event) override;
+
 private slots:
-    void showCourseDetails(QTreeWidgetItem* item, int col);   // 显示课程详情
+    void showCourseDetails(const QModelIndex& index);   // 显示课程详情
     void generateSchedule();    // 生成选课方案
     void exportSchedule();      // 导出选课方案
     void addSelectedCourse();   // 添加选中的课程
@@ -30,32 +41,61 @@ private slots:
     void setCreditLimits(int limit); // 设置学期学分上限
     void showScheduleConflicts(); // 显示课程冲突
     void showPrerequisites();     // 显示先修课程要求
+    void filterCourses();        // 按检索词与空闲时间过滤课程树
+    void nextAlternative();      // 在后台计算下一个备选方案
+    void showAlternative(int index);  // 切换到已算出的第 index 个备选方案
 
 private:
     void setupCourseTab();       // 设置课程浏览页
     void setupScheduleTab();     // 设置课表页
     void setupPreferenceTab();   // 设置偏好页
-    void loadCourses();          // 加载课程数据
+    void loadCourses();          // 在后台开始加载课程数据
+    void finishLoading(bool ok); // 目录与先修图就绪，启用排课操作
+    void setSchedulingEnabled(bool enabled);
+    void expandCourseGroups();
     void updateScheduleView();   // 更新课表视图
+    int applyCourseFilter();     // 重新计算课程树的过滤结果，返回匹配课程数，不过滤时为 -1
+    ScheduleJob* startScheduleJob(std::shared_ptr<const ScheduleSnapshot> snapshot,
+                                  std::unique_ptr<ScheduleSolver> solver);
+    void cancelScheduleJob();    // 放弃正在后台进行的排课
+    void resetAlternatives();    // 排课输入变化后丢弃已算出的备选方案
     void showStatusMessage(const QString& msg, bool isError = false);  // 显示状态信息
+    QModelIndex selectedCourse() const;   // 课程树中当前选中的课程，未选中课程时无效
 
     QTabWidget*   mainTabs = nullptr;
     // 课程浏览
-    QTreeWidget*  courseTree = nullptr;
+    QLineEdit*    searchEdit = nullptr;
+    QComboBox*    freeTimeCombo = nullptr;   // 0 项为不限，其余为“第 N 学期空闲时间可排”
+    QTreeView*    courseTree = nullptr;
+    CourseTreeModel* courseModel = nullptr;
     QTableWidget* courseDetail = nullptr;
     QPushButton*  addButton = nullptr;
     QPushButton*  removeButton = nullptr;
+    QPushButton*  prerequisiteButton = nullptr;   // 查看所选课程的先修链与后续课程
     QPushButton*  preferenceButton = nullptr;
 
     // 课表展示
     QTabWidget*   semesterTabs = nullptr;
+    QVector<TimetableView*> timetables;   // 每学期一个课表视图
     QPushButton*  genButton = nullptr;
     QPushButton*  expButton = nullptr;
     QPushButton*  conflictButton = nullptr;
+    ScheduleJob*  scheduleJob = nullptr;   // 正在进行的后台排课，没有时为空
+    QSpinBox*     diversitySpinBox = nullptr;   // 备选方案之间至少相差的课程数
+    QPushButton*  moreButton = nullptr;
+    QComboBox*    alternativeCombo = nullptr;   // 第 i 项对应 alternatives[i]
+    // 备选方案按得分从高到低逐个计算；枚举器引用快照中的目录与先修图
+    std::shared_ptr<const ScheduleSnapshot> alternativeSnapshot;
+    std::shared_ptr<ScheduleEnumerator> enumerator;
+    QPointer<ScheduleJob> enumeratorJob;   // 最近一次使用 enumerator 的任务，释放后自动置空
+    // 已算出的备选方案在界面线程的副本，由 finished 逐个追加；enumerator->results()
+    // 会被后台任务修改，界面不直接读取
+    QVector<ScheduleSolution> alternatives;
 
     // 偏好设置面板
     QWidget*      preferenceTab = nullptr;
     QSpinBox*     creditSpinBox = nullptr;
+    QSpinBox*     creditCapSpinBox = nullptr;
     QComboBox*    semesterCombo = nullptr;
     QComboBox*    dayCombo = nullptr;
     QTableWidget* timeTable = nullptr;
@@ -64,9 +104,14 @@ private:
     QLabel*       statusLabel = nullptr;
 
     // 数据
-    QList<Course>       courses;
     JsonParser          parser;
-    ScheduleManager*    schedMgr = nullptr;
+    ScheduleManager*    schedMgr = nullptr;   // 目录加载完成前为空
+    CatalogLoader*      catalogLoader = nullptr;
+    CourseSearchIndex   searchIndex;          // 课程名称 / ID / 教师检索，随目录一起构建
+
+    // 启动耗时（自窗口构造起），用于跟踪启动性能
+    QElapsedTimer startupTimer;
+    bool firstFrameLogged = false;
 
     QSet<QString> manuallySelected;
 };
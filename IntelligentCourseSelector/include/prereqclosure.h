@@ -0,0 +1,61 @@
+#ifndef PREREQCLOSURE_H
+#define PREREQCLOSURE_H
+
+#include <QVector>
+#include "prereqgraph.h"
+
+// 先修关系的传递闭包：每门课程的全部（直接与间接）先修课、全部后续课程，
+// 以及最长先修链深度。目录载入时沿拓扑序一次建好，之后“A 是否依赖 B”
+// 只需在有序下标表中二分查找，完整先修链与后续课程直接返回一段区间。
+// 稠密位集需要 n² 位（10 万门课程约 1.2 GB），而先修链通常只有几层，
+// 因此存放每门课程的有序下标表，占用与闭包中的依赖对数成正比。
+// 成环（或依赖成环课程）的课程没有拓扑位置，深度为 -1、闭包为空；
+// 未知先修课程不计入闭包，是否可排仍由 CourseCatalog::hasUnresolvedPrerequisite 决定
+class PrereqClosure {
+public:
+    using Range = IndexRange;
+
+    // 依赖对数上限：先修表与后续课程表各占 4 字节/对，达到上限时共约 512 MB；
+    // 超出时放弃闭包表，只保留深度，isComplete() 为 false
+    static constexpr qsizetype MaxPairs = qsizetype(1) << 26;
+
+    PrereqClosure() = default;
+    explicit PrereqClosure(const PrereqGraph& graph);
+
+    int nodeCount() const { return depths.size(); }
+    bool isComplete() const { return complete; }
+    qsizetype pairCount() const { return ancestorList.size(); }
+
+    // 最长先修链的长度：无先修为 0，也即最早可排的学期下标；成环为 -1
+    int depth(int course) const { return depths[course]; }
+    // 全部先修课 / 全部后续课程，按下标升序；isComplete() 为 false 时为空区间
+    Range ancestors(int course) const {
+        if (ancestorFirst.isEmpty()) return Range{};
+        const int* base = ancestorList.constData() + ancestorFirst[course];
+        return Range{base, base + ancestorCount[course]};
+    }
+    Range descendants(int course) const {
+        return rangeOf(descendantStart, descendantList, course);
+    }
+    // course 是否直接或间接以 pre 为先修；闭包不完整时改为沿 graph 的先修边搜索
+    bool dependsOn(const PrereqGraph& graph, int course, int pre) const;
+
+private:
+    static Range rangeOf(const QVector<int>& start, const QVector<int>& list, int node) {
+        if (start.isEmpty()) return Range{};
+        const int* base = list.constData();
+        return Range{base + start[node], base + start[node + 1]};
+    }
+
+    QVector<int> depths;
+    // 先修表按拓扑序存放（即构建时的合并缓冲区），课程 c 的区间为
+    // [ancestorFirst[c], ancestorFirst[c] + ancestorCount[c])；未建闭包时为空
+    QVector<int> ancestorFirst;
+    QVector<int> ancestorCount;
+    QVector<int> ancestorList;
+    QVector<int> descendantStart;   // 长度 n+1，未建闭包时为空
+    QVector<int> descendantList;
+    bool complete = true;
+};
+
+#endif // PREREQCLOSURE_H
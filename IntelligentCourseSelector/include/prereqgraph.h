@@ -0,0 +1,45 @@
+#ifndef PREREQGRAPH_H
+#define PREREQGRAPH_H
+
+#include <QList>
+#include <QVector>
+#include "catalog.h"
+
+// 先修课程有向图（CSR 存储）
+// 正向边：先修课 -> 依赖它的课程；反向边：课程 -> 其先修课
+class PrereqGraph {
+public:
+    using Range = IndexRange;
+
+    PrereqGraph() = default;
+    explicit PrereqGraph(const CourseCatalog& catalog);
+
+    int nodeCount() const { return blocked.size(); }
+    int edgeCount() const { return forwardTargets.size(); }
+
+    Range dependents(int course) const {
+        return rangeOf(forwardStart, forwardTargets, course);
+    }
+    Range prerequisites(int course) const {
+        return rangeOf(reverseStart, reverseTargets, course);
+    }
+
+    // Kahn 拓扑排序，O(V+E)；存在环或未知先修课时返回 false，
+    // cycles 中给出每个环（强连通分量）包含的课程下标
+    bool sort(QVector<int>& order, QList<QVector<int>>* cycles = nullptr) const;
+
+private:
+    static Range rangeOf(const QVector<int>& start, const QVector<int>& targets, int node) {
+        const int* base = targets.constData();
+        return Range{base + start[node], base + start[node + 1]};
+    }
+    QList<QVector<int>> findCycles(const QVector<bool>& remaining) const;
+
+    QVector<int> forwardStart;     // 长度 n+1
+    QVector<int> forwardTargets;
+    QVector<int> reverseStart;     // 长度 n+1
+    QVector<int> reverseTargets;
+    QVector<bool> blocked;         // 引用了未知先修课程，永远不可排
+};
+
+#endif // PREREQGRAPH_H
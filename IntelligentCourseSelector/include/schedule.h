@@ -6,7 +6,15 @@
 #include <QMap>
 #include <QSet>
 #include <QVector>
+#include <QBitArray>
 #include "course.h"
+#include "catalog.h"
+#include "prereqclosure.h"
+#include "prereqgraph.h"
+#include "slotindex.h"
+#include "slotmask.h"
+#include "solver.h"
+#include <memory>
 
 // 单条排课结果
 struct ScheduledCourse {
@@ -15,18 +23,57 @@ struct ScheduledCourse {
     int semester;
 };
 
+// 独立于 ScheduleManager 的求解输入：目录与先修图按值持有（隐式共享，复制代价很小），
+// problem 指向本对象内的副本。后台线程只读它，界面线程可以同时修改 ScheduleManager
+struct ScheduleSnapshot {
+    CourseCatalog catalog;
+    PrereqGraph graph;
+    PrereqClosure closure;
+    ScheduleProblem problem;
+};
+
 class ScheduleManager {
 public:
     ScheduleManager(const QList<Course>& courses);
+    // 直接使用已构建的目录（如建在内存映射的 BinaryCatalog 上的目录）
+    explicit ScheduleManager(CourseCatalog catalog);
+
+    // 替换课程目录；先修图与拓扑序只在此处重建
+    void setCourses(const QList<Course>& courses);
+    void setCatalog(CourseCatalog catalog);
 
     QList<QString> topologicalSort() const;
+    QList<QStringList> prerequisiteCycles() const;  // 每个循环依赖包含的课程ID
     bool generateSchedule();
 
+    // 排课策略，默认为 GreedySolver
+    void setSolver(std::unique_ptr<ScheduleSolver> s);
+    const ScheduleSolver* getSolver() const { return solver.get(); }
+    ScheduleProblem makeProblem() const;      // 当前输入的只读快照
+    std::shared_ptr<const ScheduleSnapshot> makeSnapshot() const;   // 可跨线程使用的输入快照
+    // 当前方案的备选方案输入：候选课程与排课限制同 makeSnapshot，总学分以当前方案的学分为上限
+    // （creditCap；setCreditCap 设得更低时取后者）。当前方案在上限内，枚举出的第一个方案就不差于它。
+    // 尚无方案时返回 nullptr
+    std::shared_ptr<const ScheduleSnapshot> makeAlternativeSnapshot() const;
+    std::unique_ptr<ScheduleSolver> cloneSolver() const { return solver->clone(); }
+    // 采用在快照上求得的方案（须来自同一目录），替换当前课表
+    bool applySolution(const ScheduleSolution& solution);
+    const CourseCatalog& getCatalog() const { return catalog; }
+    const ScheduleSolution& getLastSolution() const { return lastSolution; }
+
     QList<ScheduledCourse> getCoursesForSemester(int sem) const;
+    QVector<Placement> getPlacementsForSemester(int sem) const;   // 下标形式，供界面直接绘制
     QList<ScheduledCourse> getAllScheduled() const;
+    // 第 sem 学期放得进空闲时间的班次 / 课程：与已排课程及屏蔽时间都不冲突（区分周次），
+    // 不考虑学分上限与先修条件。课程版本不含已排课程，均按下标升序
+    QVector<int> getFreeOfferings(int sem) const;
+    QVector<int> getFittingCourses(int sem) const;
 
     void setCreditLimit(int semester, int limit);
-    void setTotalCreditLimit(int credit);  // ✅ 新增总学分限制接口
+    void setCreditTarget(int credit);  // 总学分目标：贪心与增量排课在总学分达到该值后不再补排未选中的课程
+    void setCreditCap(int credit);     // 总学分上限：精确、局部搜索与备选方案不超过该值，0 表示不限；贪心不看它
+    // 旧名称，即 setCreditTarget
+    [[deprecated("use setCreditTarget")]] void setTotalCreditLimit(int credit) { setCreditTarget(credit); }
     void setPriority(const QString& courseId, int priority);
     int getPriority(const QString& courseId) const;
 
@@ -37,22 +84,60 @@ public:
     void addCourse(const QString& courseId);
     void removeCourse(const QString& courseId);
 
+    // 增量排课：在现有课表上选中 / 取消一门课程，只修补受影响的学期与
+    // 经先修关系依赖它的课程，其余已排课程保持不动。
+    // insertCourse 无法排入时返回 false（课程仍记为选中，下次 generateSchedule 会再尝试）
+    bool insertCourse(const QString& courseId);
+    bool retractCourse(const QString& courseId);
+
     int getCreditSum(int semester) const;
     bool hasTimeConflict(int semester) const;
     QList<QString> getPrerequisites(const QString& courseId) const;
+    // 基于先修闭包：全部直接与间接先修课（按先修链深度、再按下标排序）、
+    // 全部后续课程（按下标），以及由最长先修链决定的最早学期（0 起，成环或未知课程为 -1）
+    QList<QString> getPrerequisiteChain(const QString& courseId) const;
+    QList<QString> getDependentCourses(const QString& courseId) const;
+    int getEarliestSemester(const QString& courseId) const;
 
 private:
-    bool checkTimeConflicts(const ScheduledCourse& newCourse) const;
-    const CourseOffering& getOffering(const ScheduledCourse& sc) const;
-    bool isPrerequisiteSatisfied(const QString& courseId, int semester) const;
+    void rebuildGraph();
+    std::shared_ptr<ScheduleSnapshot> newSnapshot() const;
+    QVector<int> allPrerequisites(int course) const;
+    QVector<int> allDependents(int course) const;
+    bool checkTimeConflicts(const Placement& newCourse) const;
+    bool isCandidate(int course) const;
+    bool canPlace(int course, int offering, int semester) const;
+    bool tryPlace(int course, const QVector<bool>* semesters = nullptr);
+    void placeDependents(int course);
+    void refill(const QVector<bool>& semesters);
+    void syncSolution();
+    void place(const Placement& pl);
+    void unplace(int index);
+    void clearSchedule();
+    ScheduledCourse toScheduled(const Placement& pl) const;
 
-    QList<Course> allCourses;
-    QList<ScheduledCourse> schedule;
+    CourseCatalog catalog;
+    PrereqGraph graph;
+    PrereqClosure closure;             // 先修传递闭包与链深度，随先修图重建
+    SlotIndex slotIndex;               // 节次 -> 班次倒排位图，随目录重建
+    QVector<int> topoOrder;            // 缓存的拓扑序（不含成环课程）
+    QVector<int> topoRank;             // 课程下标 -> 在 topoOrder 中的位置，成环课程为 -1
+    QVector<int> greedyOrder;          // 按优先级稳定排序的拓扑序，与贪心求解器一致
+    bool greedyOrderDirty = true;
+    QList<QVector<int>> cycles;        // 缓存的循环依赖
+    QVector<Placement> schedule;
+    QVector<int> placedSemester;   // 课程下标 -> 已排学期，未排为 -1
     QVector<int> creditLimits;
-    QMap<QString, int> priorities;
-    QVector<QVector<quint32>> blockedTime;
-    QSet<QString> selectedCourses;
-    int totalCreditLimit = 0;
+    QVector<int> priorities;       // 课程下标 -> 优先级
+    QVector<SlotMask> blockedTime;  // 学期 -> 屏蔽时间
+    QVector<WeekOccupancy> occupancy;  // 学期 -> 已排课程占用的时间（周 × 天 × 节次）
+    QVector<int> semCredits;        // 学期 -> 已排学分
+    int totalCredit = 0;
+    QBitArray selectedCourses;     // 课程下标 -> 是否被手动选中
+    int creditTarget = 0;
+    int creditCap = 0;
+    std::unique_ptr<ScheduleSolver> solver;
+    ScheduleSolution lastSolution;
 };
 
 #endif // SCHEDULE_H
@@ -0,0 +1,56 @@
+#ifndef SCHEDULEJOB_H
+#define SCHEDULEJOB_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <atomic>
+#include <memory>
+#include "schedule.h"
+
+class QThread;
+
+// 在后台线程中求解一份输入快照。信号由求解线程发出，以排队连接送到接收者所在线程；
+// 阶段性最优解至多每 100 ms 报告一次，间隔内到达的更优解暂存，在之后的检查点上补发。
+// cancel() 不等待：先在调用线程上补发暂存的最优解，求解器在下一个检查点退出，
+// 之后只发出 canceled()，不再发出 finished()。finished() / canceled() 之后可以 deleteLater()
+class ScheduleJob : public QObject, private SolveMonitor {
+    Q_OBJECT
+public:
+    ScheduleJob(std::shared_ptr<const ScheduleSnapshot> snapshot,
+                std::unique_ptr<ScheduleSolver> solver, QObject* parent = nullptr);
+    ~ScheduleJob() override;   // 取消并等待求解线程结束（不再补发暂存的最优解）
+
+    void start();
+    void cancel();
+    bool isRunning() const;
+
+signals:
+    void progressChanged(int percent);
+    void bestChanged(const ScheduleSolution& best);
+    void finished(const ScheduleSolution& solution, bool ok);
+    void canceled();
+
+private:
+    void run();
+    bool isCanceled() const override;
+    void progress(int percent) override;
+    void improved(const ScheduleSolution& best) override;
+    // 发出暂存的最优解；force 为 false 时只在距上次报告满 100 ms 后发出
+    void flushPending(bool force);
+
+    std::shared_ptr<const ScheduleSnapshot> snapshot;   // problem 中的指针指向它
+    std::unique_ptr<ScheduleSolver> solver;
+    ScheduleProblem problem;
+    QThread* thread = nullptr;
+    std::atomic<bool> cancelRequested{false};
+    std::atomic<int> lastPercent{-1};
+    std::atomic<bool> hasPending{false};   // 检查点上不加锁地判断是否有暂存的最优解
+
+    QMutex reportMutex;           // 保护以下成员（并行求解时多个线程同时报告）
+    QElapsedTimer sinceReport;
+    qint64 reportedScore = -1;
+    ScheduleSolution pending;     // 节流间隔内到达、尚未发出的最优解（hasPending 为 true 时有效）
+};
+
+#endif // SCHEDULEJOB_H
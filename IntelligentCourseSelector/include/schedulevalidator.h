@@ -0,0 +1,51 @@
+#ifndef SCHEDULEVALIDATOR_H
+#define SCHEDULEVALIDATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include <QByteArray>
+#include "catalog.h"
+#include "schedule.h"
+
+// 单份排课方案的校验结果
+struct ValidationResult {
+    QString studentId;
+    QStringList errors;          // 为空表示方案合法
+    int credits = 0;             // 目录中存在的已排课程学分之和
+
+    bool isValid() const { return errors.isEmpty(); }
+};
+
+// 排课方案校验：检查课程与班号是否存在、课程是否重复、先修课是否排在更早的学期、
+// 同一学期内是否时间冲突（区分周次）。ID 先驻留为目录下标，每学期一张占用位图，
+// 每门课只做一次 128 位冲突检测，只有真的冲突时才回头找出冲突的课程。
+// 目录须在使用期间保持有效
+class ScheduleValidator {
+public:
+    static constexpr int MaxSemesters = 64;
+
+    explicit ScheduleValidator(const CourseCatalog& catalog);
+
+    void setThreadCount(int n) { threads = n; }
+
+    ValidationResult validate(const QList<ScheduledCourse>& schedule) const;
+    // 并行解析并校验一批 JSON 文档（schedule.json 数组，或含 student_id 与 schedule 的对象），
+    // 结果与输入一一对应；无法解析的文档记为一条错误
+    QVector<ValidationResult> run(const QVector<QByteArray>& documents) const;
+
+    // 解析一份排课方案（schedule.json 数组，或 coursesel_batch 输出的一行结果对象），
+    // 兼容 data/checker.cpp 接受的 id / class 字段名；序列化一条校验结果（单行 JSON）
+    static bool parseDocument(const QByteArray& data, QString& studentId,
+                              QList<ScheduledCourse>& out);
+    static QByteArray resultToJson(const ValidationResult& result);
+
+private:
+    QString describe(int course) const;   // "ID（名称）"
+
+    const CourseCatalog& catalog;
+    int threads = 0;             // 0 表示使用全部核心
+};
+
+#endif // SCHEDULEVALIDATOR_H
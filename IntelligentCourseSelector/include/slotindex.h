@@ -0,0 +1,36 @@
+#ifndef SLOTINDEX_H
+#define SLOTINDEX_H
+
+#include <QVector>
+#include "catalog.h"
+#include "slotmask.h"
+
+// 节次 -> 班次的倒排位图：节次位 b（与 SlotMask / WeekOccupancy 的位下标一致）
+// 对应一个按班次下标排列的位集，记录在该节次上课的全部班次。
+// “哪些班次放得进空闲时间”只需对被占用的节次做位集 ANDNOT，
+// 代价与被占节次数 × 班次数 / 64 成正比，不必逐个班次检查冲突
+class SlotIndex {
+public:
+    SlotIndex() = default;
+    explicit SlotIndex(const CourseCatalog& catalog);
+
+    int offeringCount() const { return offerings; }
+
+    // 与 occupied 及 blocked 都不冲突的班次下标（升序），结果与逐个调用
+    // occupied.conflicts / blocked.intersects 相同：blocked 中的节次不区分周次，
+    // occupied 中占满所有周的节次直接排除，其余节次只校验与之相交的候选班次的周次
+    QVector<int> freeOfferings(const WeekOccupancy& occupied, const SlotMask& blocked,
+                               const CourseCatalog& catalog) const;
+
+private:
+    static constexpr int Bits = 128;
+
+    const quint64* slot(int bit) const { return bits.constData() + qsizetype(bit) * words; }
+
+    int offerings = 0;
+    int words = 0;               // 每个位集的 64 位字数
+    QVector<quint64> bits;       // 节次位 b 的位集为 bits[b * words, (b + 1) * words)
+    QVector<quint64> noWeeks;    // 周次为空（从不上课）的班次
+};
+
+#endif // SLOTINDEX_H
@@ -0,0 +1,139 @@
+#ifndef SLOTMASK_H
+#define SLOTMASK_H
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <cstring>
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SLOTMASK_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// 一周的时间占用位图：7 天 × 16 位（低 13 位对应 13 节课），
+// 打包成一个 128 位向量，冲突检测只需一次 AND
+struct alignas(16) SlotMask {
+    quint16 day[8] = {};   // day[7] 恒为 0，仅用于补齐 128 位
+
+    static SlotMask fromTimes(const quint32 times[7]) {
+        SlotMask m;
+        for (int d = 0; d < 7; ++d)
+            m.day[d] = static_cast<quint16>(times[d]);
+        return m;
+    }
+
+    bool isEmpty() const {
+        quint64 w[2];
+        std::memcpy(w, day, sizeof(w));
+        return (w[0] | w[1]) == 0;
+    }
+
+    // 任意一天的任意一节重叠即返回 true
+    bool intersects(const SlotMask& o) const {
+#if defined(__SSE4_1__)
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(day));
+        __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(o.day));
+        return !_mm_testz_si128(a, b);
+#elif defined(SLOTMASK_SSE2)
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(day));
+        __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(o.day));
+        __m128i z = _mm_cmpeq_epi8(_mm_and_si128(a, b), _mm_setzero_si128());
+        return _mm_movemask_epi8(z) != 0xFFFF;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        uint64x2_t v = vreinterpretq_u64_u16(vandq_u16(vld1q_u16(day), vld1q_u16(o.day)));
+        return (vgetq_lane_u64(v, 0) | vgetq_lane_u64(v, 1)) != 0;
+#else
+        quint64 a[2], b[2];
+        std::memcpy(a, day, sizeof(a));
+        std::memcpy(b, o.day, sizeof(b));
+        return ((a[0] & b[0]) | (a[1] & b[1])) != 0;
+#endif
+    }
+
+    SlotMask& operator|=(const SlotMask& o) {
+        for (int d = 0; d < 8; ++d) day[d] |= o.day[d];
+        return *this;
+    }
+
+    SlotMask operator|(const SlotMask& o) const {
+        SlotMask m = *this;
+        m |= o;
+        return m;
+    }
+
+    SlotMask operator&(const SlotMask& o) const {
+        SlotMask m;
+        for (int d = 0; d < 8; ++d) m.day[d] = day[d] & o.day[d];
+        return m;
+    }
+
+    // 依次以位下标回调每个置位的节次，回调返回 true 时提前结束。
+    // 位下标按两个 64 位字编号，范围 [0, 128)，只保证与 clearBit 一致
+    template <typename F>
+    bool anyBit(F&& f) const {
+        quint64 w[2];
+        std::memcpy(w, day, sizeof(w));
+        for (int k = 0; k < 2; ++k) {
+            for (quint64 v = w[k]; v; v &= v - 1) {
+                if (f(k * 64 + int(qCountTrailingZeroBits(v)))) return true;
+            }
+        }
+        return false;
+    }
+
+    void clearBit(int bit) {
+        quint64 w[2];
+        std::memcpy(w, day, sizeof(w));
+        w[bit / 64] &= ~(quint64(1) << (bit % 64));
+        std::memcpy(day, w, sizeof(w));
+    }
+
+    // 清除 o 中置位的节次（移除已排课程时使用）
+    void remove(const SlotMask& o) {
+        for (int d = 0; d < 8; ++d) day[d] &= ~o.day[d];
+    }
+
+    void clear() { *this = SlotMask(); }
+};
+
+// 一个学期的三维占用（周 × 天 × 节次）。any 是至少有一周被占用的节次，
+// weeks[b] 是节次位 b 被占用的周；两个班次只有同时共享节次与周才算冲突。
+// 不共享节次（绝大多数情况）时只需对 any 做一次 128 位 AND，与不区分周次时开销相同，
+// 共享节次时再逐个比较这些节次的周掩码
+struct WeekOccupancy {
+    SlotMask any;
+    quint32 weeks[128] = {};
+
+    bool conflicts(const SlotMask& m, quint32 w) const {
+        if (!m.intersects(any)) return false;
+        return (m & any).anyBit([this, w](int b) { return (weeks[b] & w) != 0; });
+    }
+
+    void add(const SlotMask& m, quint32 w) {
+        if (w == 0) return;
+        any |= m;
+        m.anyBit([this, w](int b) { weeks[b] |= w; return false; });
+    }
+
+    // 同一学期内已排班次互不冲突，同一节次上各班次的周互不相交，因此可以按位精确移除
+    void remove(const SlotMask& m, quint32 w) {
+        m.anyBit([this, w](int b) {
+            weeks[b] &= ~w;
+            if (weeks[b] == 0) any.clearBit(b);
+            return false;
+        });
+    }
+
+    bool isEmpty() const { return any.isEmpty(); }
+    void clear() { *this = WeekOccupancy(); }
+};
+
+#ifdef SLOTMASK_SSE2
+#undef SLOTMASK_SSE2
+#endif
+
+#endif // SLOTMASK_H
@@ -0,0 +1,255 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <QString>
+#include <QVector>
+#include <QBitArray>
+#include <memory>
+#include "catalog.h"
+#include "prereqclosure.h"
+#include "prereqgraph.h"
+#include "slotmask.h"
+
+// 内部排课记录，全部使用 CourseCatalog 中的驻留下标
+struct Placement {
+    int course;
+    int offering;
+    int semester;
+
+    bool operator==(const Placement& o) const {
+        return course == o.course && offering == o.offering && semester == o.semester;
+    }
+    bool operator!=(const Placement& o) const { return !(*this == o); }
+};
+
+class SolveMonitor;
+
+// 排课求解输入快照，求解期间只读
+struct ScheduleProblem {
+    const CourseCatalog* catalog = nullptr;
+    const PrereqGraph* graph = nullptr;
+    const PrereqClosure* closure = nullptr;  // 可选；有时用最长先修链深度预先剪掉排不进的课程
+    QVector<int> order;              // 拓扑序（不含成环或先修未知的课程）
+    QVector<int> priorities;         // 课程下标 -> 优先级
+    QBitArray selected;              // 课程下标 -> 是否被手动选中
+    QVector<int> creditLimits;       // 学期 -> 学分上限
+    QVector<SlotMask> blocked;       // 学期 -> 屏蔽时间
+    int creditTarget = 0;            // 总学分目标：达到后贪心不再排入未手动选中的课程
+    int creditCap = 0;               // 总学分上限，0 表示不限；分支定界、局部搜索与枚举遵守
+    SolveMonitor* monitor = nullptr; // 可选的进度 / 取消回调，不属于输入数据
+
+    int semesterCount() const { return creditLimits.size(); }
+    // 手动选中或优先级不低于 5 的课程才参与排课
+    bool isCandidate(int course) const {
+        return selected.testBit(course) || priorities[course] >= 5;
+    }
+    // 先修链长度已超过学期数，无论如何都排不进（未提供闭包时不做判断）
+    bool tooDeep(int course) const {
+        return closure && closure->depth(course) >= semesterCount();
+    }
+    // 目标函数：优先级加权学分
+    qint64 value(int course) const {
+        return qint64(priorities[course]) * catalog->credit(course);
+    }
+};
+
+// 求解结果
+struct ScheduleSolution {
+    QVector<Placement> placements;
+    qint64 score = 0;        // 优先级加权学分之和
+    int credits = 0;
+    bool optimal = false;    // 搜索是否在预算内完整结束
+    qint64 nodes = 0;        // 搜索节点数（贪心为 0）
+};
+
+// 求解过程观察者。求解器在检查点上询问是否取消、报告进度与更优的方案；
+// 并行求解时回调可能同时来自多个工作线程，实现须线程安全
+class SolveMonitor {
+public:
+    virtual ~SolveMonitor() = default;
+    virtual bool isCanceled() const = 0;
+    virtual void progress(int percent) = 0;                   // 估计进度 0-100
+    virtual void improved(const ScheduleSolution& best) = 0;  // 找到更优的方案
+};
+
+// 求解过程中的可变状态：各学期学分、占用位图、课程所在学期
+struct SolverState {
+    explicit SolverState(const ScheduleProblem& p);
+
+    // 先修课全部已排时返回最早可排学期，否则返回 -1
+    int earliestSemester(int course) const;
+    // 只检查学分与时间冲突，先修条件由 earliestSemester 保证
+    bool canPlace(int course, int offering, int semester) const;
+    void place(const Placement& pl);
+    void unplace(const Placement& pl);
+
+    const ScheduleProblem& problem;
+    QVector<int> semCredit;
+    QVector<WeekOccupancy> occupancy;   // 学期 -> 已排班次与屏蔽时间（屏蔽时间占满所有周）
+    QVector<int> placedSemester;
+    QVector<int> placedOffering;        // 课程下标 -> 已排班次，未排为 -1
+    int totalCredit = 0;
+    qint64 score = 0;
+};
+
+// 排课策略接口
+class ScheduleSolver {
+public:
+    virtual ~ScheduleSolver() = default;
+    virtual QString name() const = 0;
+    // 被 problem.monitor 取消时，贪心返回 false，分支定界与局部搜索返回当前最优解（optimal 为 false）
+    virtual bool solve(const ScheduleProblem& problem, ScheduleSolution& out) = 0;
+    // 复制策略及其参数，供后台求解使用，避免与界面线程共用同一对象
+    virtual std::unique_ptr<ScheduleSolver> clone() const = 0;
+};
+
+// 贪心：按优先级依次放入最早的学期与第一个不冲突的班次，
+// 总学分达到 creditTarget 后只再排手动选中的课程（可以越过目标），不看 creditCap
+class GreedySolver : public ScheduleSolver {
+public:
+    QString name() const override { return "greedy"; }
+    bool solve(const ScheduleProblem& problem, ScheduleSolution& out) override;
+    std::unique_ptr<ScheduleSolver> clone() const override {
+        return std::unique_ptr<ScheduleSolver>(new GreedySolver(*this));
+    }
+};
+
+// 分支定界：在 (课程, 学期, 班次) 上做精确搜索，最大化优先级加权学分；
+// 总学分不超过 creditCap（0 表示不限），不看 creditTarget；超出时间预算则返回当前最优解
+class BranchBoundSolver : public ScheduleSolver {
+public:
+    explicit BranchBoundSolver(int timeBudgetMs = 2000) : budgetMs(timeBudgetMs) {}
+
+    QString name() const override { return "branch-and-bound"; }
+    bool solve(const ScheduleProblem& problem, ScheduleSolution& out) override;
+    std::unique_ptr<ScheduleSolver> clone() const override {
+        return std::unique_ptr<ScheduleSolver>(new BranchBoundSolver(*this));
+    }
+
+    void setTimeBudget(int ms) { budgetMs = ms; }
+    int timeBudget() const { return budgetMs; }
+    // 种子决定同价值课程的展开顺序，0 表示按拓扑序
+    void setSeed(quint32 s) { seed = s; }
+
+private:
+    int budgetMs;
+    quint32 seed = 0;
+};
+
+// 并行分支定界：把前 splitDepth 门高优先级课程的 (学期, 班次) 选择拆成子树，
+// 交给工作窃取线程池搜索，各线程通过原子变量共享当前最优分数剪枝。
+// 同分方案按深度优先顺序取舍，因此搜索完整结束时结果只取决于种子；
+// 设置 nodeBudget 后每个子树按固定节点数截断、不共享界也不看时间预算，截断结果同样可复现
+class ParallelBranchBoundSolver : public ScheduleSolver {
+public:
+    explicit ParallelBranchBoundSolver(int threadCount = 0, int timeBudgetMs = 2000)
+        : threads(threadCount), budgetMs(timeBudgetMs) {}
+
+    QString name() const override { return "parallel-branch-and-bound"; }
+    bool solve(const ScheduleProblem& problem, ScheduleSolution& out) override;
+    std::unique_ptr<ScheduleSolver> clone() const override {
+        return std::unique_ptr<ScheduleSolver>(new ParallelBranchBoundSolver(*this));
+    }
+
+    void setTimeBudget(int ms) { budgetMs = ms; }
+    void setSeed(quint32 s) { seed = s; }
+    void setSplitDepth(int k) { splitDepth = qMax(0, k); }
+    void setNodeBudget(qint64 nodes) { nodeBudget = nodes; }
+
+private:
+    int threads;             // 0 表示使用全部核心
+    int budgetMs;
+    quint32 seed = 0;
+    int splitDepth = 3;
+    qint64 nodeBudget = 0;   // 每个子树的节点上限，0 表示不限
+};
+
+// 局部搜索求解过程中的一次改进：用时、得分与已尝试的移动数
+struct ImprovementPoint {
+    qint64 ms;
+    qint64 score;
+    qint64 moves;
+};
+
+// 局部搜索：以贪心方案为起点做模拟退火，在时间预算内持续改进（随时可取当前最优）。
+// 移动包括：换班次 / 换学期、交换两门已排课程的学期、插入未排课程、
+// 以及挤出与之冲突的已排课程后插入（得分可能下降，按退火温度接受）。
+// 各移动都只在占用位图上增删一两个班次，冲突与得分变化都是 O(1) 判定；挤出时按学期的
+// 节次占用表找冲突课程，开销与新班次的节次数相当，与已排课程数无关；
+// 先修约束按直接先修 / 后续课程的学期检查，被挤出的课程在若干步内不再插回（禁忌）。
+// 与分支定界一样遵守 creditCap（贪心起点已超出时以起点为准）；贪心起点按 creditTarget 求得
+class LocalSearchSolver : public ScheduleSolver {
+public:
+    explicit LocalSearchSolver(int timeBudgetMs = 2000) : budgetMs(timeBudgetMs) {}
+
+    QString name() const override { return "local-search"; }
+    bool solve(const ScheduleProblem& problem, ScheduleSolution& out) override;
+    std::unique_ptr<ScheduleSolver> clone() const override {
+        return std::unique_ptr<ScheduleSolver>(new LocalSearchSolver(*this));
+    }
+
+    void setTimeBudget(int ms) { budgetMs = ms; }
+    int timeBudget() const { return budgetMs; }
+    // 移动步数预算，0 表示只按时间预算。设置后退火温度按已走步数下降，
+    // 同一种子在步数预算先于时间预算用完时得到相同的结果
+    void setMoveBudget(qint64 moves) { moveBudget = moves; }
+    void setSeed(quint32 s) { seed = s; }
+    // 上一次 solve 的改进曲线，第一个点为贪心起点
+    const QVector<ImprovementPoint>& improvements() const { return curve; }
+
+private:
+    int budgetMs;
+    qint64 moveBudget = 0;
+    quint32 seed = 1;
+    QVector<ImprovementPoint> curve;
+};
+
+// 按优先级加权得分从高到低逐个给出不同的排课方案（Lawler 划分）。
+// 每给出一个方案，就把它所在的搜索子空间沿分支定界的决策顺序拆成互不相交的子空间；
+// 新子空间只按上界入队，出队时才在共享的搜索模型上做一次分支定界，
+// 因此下一个方案只在调用 next() 时计算，且只搜索前缀已固定的小子空间。
+// minDistance 为方案之间的最小差异：每个新方案至少有 minDistance 门课程的安排
+// （是否排入、所在学期或班次）与此前给出的每个方案都不同，即按差异约束依次取最优。
+// 与分支定界一样，上课时间完全相同的班次视为同一种安排。
+// problem 中的指针须在枚举器的生命周期内有效；同一时刻只能在一个线程中使用
+class ScheduleEnumerator {
+public:
+    explicit ScheduleEnumerator(const ScheduleProblem& problem, int minDistance = 1);
+    ~ScheduleEnumerator();
+
+    // 每个子空间的搜索时间预算，超出时取该子空间已找到的最优方案（optimal 为 false）
+    void setTimeBudget(int ms);
+    int minDistance() const;
+
+    // 计算下一个方案。没有更多满足差异约束的方案，或被 monitor 取消时返回 false；
+    // 取消不丢失状态，之后可以再次调用
+    bool next(ScheduleSolution& out, SolveMonitor* monitor = nullptr);
+    const QVector<ScheduleSolution>& results() const;
+
+    // 两个方案中安排不同的课程数
+    static int distance(const QVector<Placement>& a, const QVector<Placement>& b);
+
+private:
+    struct State;
+    std::unique_ptr<State> d;
+};
+
+// 把枚举器包装成求解器，每次 solve 取下一个方案，便于交给 ScheduleJob 在后台计算。
+// 克隆体共享同一个枚举器；solve 只使用 problem.monitor，输入以创建枚举器时的 problem 为准
+class NextScheduleSolver : public ScheduleSolver {
+public:
+    explicit NextScheduleSolver(std::shared_ptr<ScheduleEnumerator> e) : enumerator(std::move(e)) {}
+
+    QString name() const override { return "top-k"; }
+    bool solve(const ScheduleProblem& problem, ScheduleSolution& out) override {
+        return enumerator->next(out, problem.monitor);
+    }
+    std::unique_ptr<ScheduleSolver> clone() const override {
+        return std::unique_ptr<ScheduleSolver>(new NextScheduleSolver(*this));
+    }
+
+private:
+    std::shared_ptr<ScheduleEnumerator> enumerator;
+};
+
+#endif // SOLVER_H
@@ -0,0 +1,46 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QSet>
+#include <QString>
+#include <QStringView>
+#include <memory>
+#include <vector>
+
+// 课程文本的去重字符串池：相同内容只存一份，字符数据按块放在池自己的 arena 中。
+// intern 返回的 QString 直接引用 arena（fromRawData，不分配、不拷贝），
+// 有效期与池相同；池通常由加载出的 CourseCatalog 通过 shared_ptr 持有。
+// 课程性质、教师、班次号以及作为先修课再次出现的课程ID大量重复，去重后
+// 每个不同的字符串只占一段 arena，不再各自分配堆内存。非线程安全，由解析线程独占
+class StringPool {
+public:
+    StringPool() = default;
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    QString intern(QStringView s);
+    // 直接接受 UTF-8（SAX 解析器给出的原始字节），解码缓冲区复用，命中时不分配
+    QString internUtf8(const char* data, qsizetype size);
+
+    int size() const { return int(index.size()); }   // 不同字符串的个数
+    qint64 lookups() const { return lookupCount; }
+    qint64 arenaBytes() const { return allocatedChars * qint64(sizeof(QChar)); }
+
+private:
+    static constexpr qsizetype BlockChars = 32 * 1024;
+
+    QChar* allocate(qsizetype n);
+    const QChar* store(QStringView s);
+
+    std::vector<std::unique_ptr<QChar[]>> blocks;
+    QChar* block = nullptr;              // 正在填充的块
+    qsizetype used = 0;                  // 当前块已用的码元数
+    qint64 allocatedChars = 0;
+    // 只存视图（16 字节/项），QString 由 fromRawData 现造；存成 QHash<QStringView, QString>
+    // 时每项 40 字节，10 万门课程的 29 万个不同字符串下索引比 arena 本身还大
+    QSet<QStringView> index;
+    std::vector<QChar> scratch;           // UTF-8 解码缓冲区
+    qint64 lookupCount = 0;
+};
+
+#endif // STRINGPOOL_H
@@ -0,0 +1,51 @@
+#ifndef TIMETABLEVIEW_H
+#define TIMETABLEVIEW_H
+
+#include <QWidget>
+#include <QVector>
+#include "catalog.h"
+#include "slotmask.h"
+#include "solver.h"
+
+// 单个学期的课表（7 天 × 13 节），直接按班次的时间位图绘制，不创建任何单元格对象；
+// 提示文本只在鼠标悬停时生成。setContents 与当前内容相同时不触发重绘
+class TimetableView : public QWidget {
+    Q_OBJECT
+public:
+    explicit TimetableView(QWidget* parent = nullptr);
+
+    // catalog 须在视图的生命周期内有效
+    void setCatalog(const CourseCatalog* catalog);
+    // 更新本学期的已排班次与屏蔽时间，返回内容是否发生变化
+    bool setContents(const QVector<Placement>& placements, const SlotMask& blocked);
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    bool event(QEvent* event) override;
+
+private:
+    static constexpr int Days = 7;
+    static constexpr int Slots = 13;
+
+    struct Entry {
+        Placement placement;
+        QString name;
+        bool compulsory;
+    };
+
+    QRect gridRect() const;
+    QRect cellRect(int day, int slot) const;
+    bool cellAt(const QPoint& pos, int& day, int& slot) const;
+    QString toolTipFor(int day, int slot) const;
+
+    const CourseCatalog* catalog = nullptr;
+    QVector<Placement> placements;
+    SlotMask blocked;
+    QVector<Entry> entries;
+    QVector<int> cells[Days * Slots];   // 单元格 -> entries 下标；周次不重叠的班次可共用单元格
+};
+
+#endif // TIMETABLEVIEW_H
@@ -0,0 +1,60 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 工作窃取线程池：每个线程有自己的双端队列，
+// 本线程从队尾取任务（LIFO），空闲时从其他线程队首窃取（FIFO）
+class WorkStealingPool {
+public:
+    // 任务参数为当前线程编号，可通过 spawn 派生子任务
+    using Task = std::function<void(int worker)>;
+
+    explicit WorkStealingPool(int threads = 0);   // 0 表示使用全部核心
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int threadCount() const { return int(workers.size()); }
+
+    // 从外部提交任务，按轮转分配到各线程队列
+    void submit(Task task);
+    // 在任务内部派生子任务，压入当前线程的队列
+    void spawn(int worker, Task task);
+    // 阻塞直到所有任务（包括派生出的子任务）执行完毕
+    void waitForDone();
+
+    quint64 stealCount() const { return steals.load(); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    void push(int worker, Task task);
+    bool pop(int worker, Task& task);
+    bool steal(int thief, Task& task);
+    void run(int worker);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex idleMutex;
+    std::condition_variable wake;       // 有新任务或需要退出
+    std::condition_variable done;       // 任务全部完成
+    std::atomic<long> pending{0};       // 已提交但未完成的任务数
+    std::atomic<quint64> steals{0};
+    std::atomic<unsigned> nextWorker{0};
+    bool stopping = false;
+};
+
+#endif // WORKSTEALINGPOOL_H
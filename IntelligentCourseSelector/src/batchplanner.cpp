@@ -0,0 +1,116 @@
+#include "batchplanner.h"
+#include "jsonparser.h"
+#include "workstealingpool.h"
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <memory>
+
+BatchPlanner::BatchPlanner(const ScheduleManager& base)
+    : baseProblem(base.makeProblem())
+{
+}
+
+PlanResult BatchPlanner::plan(const PlanRequest& req) const {
+    PlanResult res;
+    res.studentId = req.studentId;
+
+    const CourseCatalog& cat = *baseProblem.catalog;
+    ScheduleProblem p = baseProblem;
+    p.priorities.fill(5);
+    p.selected.fill(false);
+    for (auto it = req.priorities.cbegin(); it != req.priorities.cend(); ++it) {
+        int c = cat.courseIndex(it.key());
+        if (c >= 0 && it.value() >= 0 && it.value() <= 10) p.priorities[c] = it.value();
+    }
+    for (const auto& id : req.selected) {
+        int c = cat.courseIndex(id);
+        if (c >= 0) p.selected.setBit(c);
+    }
+    for (int sem = 0; sem < req.creditLimits.size() && sem < p.creditLimits.size(); ++sem)
+        p.creditLimits[sem] = req.creditLimits[sem];
+    for (const auto& b : req.blocked) {
+        if (b.semester < 0 || b.semester >= p.blocked.size() || b.day < 0 || b.day >= 7) {
+            res.error = QString("非法的屏蔽时间：学期 %1 星期 %2").arg(b.semester).arg(b.day);
+            return res;
+        }
+        p.blocked[b.semester].day[b.day] |= static_cast<quint16>(b.mask);
+    }
+    p.creditTarget = req.creditTarget;
+    p.creditCap = req.creditCap;
+
+    std::unique_ptr<ScheduleSolver> solver;
+    if (engine == Engine::BranchBound)
+        solver.reset(new BranchBoundSolver(budgetMs));
+    else if (engine == Engine::LocalSearch)
+        solver.reset(new LocalSearchSolver(budgetMs));
+    else
+        solver.reset(new GreedySolver);
+
+    ScheduleSolution sol;
+    if (!solver->solve(p, sol)) {
+        res.error = "求解失败";
+        return res;
+    }
+    for (const auto& pl : sol.placements)
+        res.schedule.append(ScheduledCourse{cat.courseId(pl.course), cat.offeringId(pl.offering), pl.semester});
+    res.score = sol.score;
+    res.credits = sol.credits;
+    res.optimal = sol.optimal;
+    return res;
+}
+
+QVector<PlanResult> BatchPlanner::run(const QVector<PlanRequest>& requests) const {
+    QVector<PlanResult> results(requests.size());
+    WorkStealingPool pool(threads);
+    for (int i = 0; i < requests.size(); ++i) {
+        pool.submit([this, &requests, &results, i](int) {
+            results[i] = plan(requests[i]);
+        });
+    }
+    pool.waitForDone();
+    return results;
+}
+
+bool BatchPlanner::parseRequest(const QByteArray& line, PlanRequest& out) {
+    QJsonParseError err;
+    QJsonDocument doc = QJsonDocument::fromJson(line, &err);
+    if (err.error != QJsonParseError::NoError || !doc.isObject()) {
+        qWarning() << "排课请求格式错误：" << err.errorString();
+        return false;
+    }
+    QJsonObject obj = doc.object();
+
+    out = PlanRequest();
+    out.studentId = obj["student_id"].toString();
+    for (const auto& v : obj["selected"].toArray())
+        out.selected.insert(v.toString());
+    QJsonObject pri = obj["priorities"].toObject();
+    for (auto it = pri.constBegin(); it != pri.constEnd(); ++it)
+        out.priorities.insert(it.key(), it.value().toInt());
+    for (const auto& v : obj["blocked"].toArray()) {
+        QJsonObject b = v.toObject();
+        out.blocked.append({b["semester"].toInt(), b["day"].toInt(),
+                            static_cast<quint32>(b["mask"].toInt())});
+    }
+    for (const auto& v : obj["credit_limits"].toArray())
+        out.creditLimits.append(v.toInt());
+    out.creditTarget = obj["total_credit_limit"].toInt();
+    out.creditCap = obj["credit_cap"].toInt();
+    return true;
+}
+
+QByteArray BatchPlanner::resultToJson(const PlanResult& r) {
+    QJsonObject obj;
+    obj["student_id"] = r.studentId;
+    if (!r.error.isEmpty()) {
+        obj["error"] = r.error;
+    } else {
+        obj["score"] = r.score;
+        obj["credits"] = r.credits;
+        obj["optimal"] = r.optimal;
+        obj["schedule"] = JsonParser().scheduleToJson(r.schedule);
+    }
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,302 @@
+#include "binarycatalog.h"
+#include <QByteArray>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QVector>
+#include <QDebug>
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<BinaryCatalog::Header>::value, "Header 必须可按字节拷贝");
+static_assert(sizeof(BinaryCatalog::Header) == 88, "Header 布局变化需要提升 Version");
+static_assert(sizeof(BinaryCatalog::CourseRecord) == 44, "CourseRecord 布局变化需要提升 Version");
+static_assert(sizeof(BinaryCatalog::OfferingRecord) == 52, "OfferingRecord 布局变化需要提升 Version");
+static_assert(sizeof(BinaryCatalog::PrereqRecord) == 12, "PrereqRecord 布局变化需要提升 Version");
+
+namespace {
+
+const char Magic[8] = {'C', 'S', 'C', 'A', 'T', 'L', 'G', '\0'};
+const quint32 ByteOrderMark = 0x01020304u;
+
+quint64 align8(quint64 v) { return (v + 7) & ~quint64(7); }
+
+// CRC-32（IEEE 802.3，反射多项式 0xEDB88320），slice-by-8：每轮查 8 张表处理 8 个字节。
+// t[k][b] 为字节 b 之后再跟 k 个零字节时的余数，逐字节读入，与主机字节序无关
+quint32 crc32(const uchar* data, qint64 size) {
+    static const auto table = [] {
+        std::array<std::array<quint32, 256>, 8> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[0][i] = c;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (quint32 i = 0; i < 256; ++i)
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+        }
+        return t;
+    }();
+    quint32 crc = 0xFFFFFFFFu;
+    for (; size >= 8; data += 8, size -= 8) {
+        const quint32 lo = crc ^ (quint32(data[0]) | quint32(data[1]) << 8 |
+                                  quint32(data[2]) << 16 | quint32(data[3]) << 24);
+        crc = table[7][lo & 0xFF] ^ table[6][(lo >> 8) & 0xFF] ^ table[5][(lo >> 16) & 0xFF] ^
+              table[4][lo >> 24] ^ table[3][data[4]] ^ table[2][data[5]] ^ table[1][data[6]] ^
+              table[0][data[7]];
+    }
+    for (; size > 0; ++data, --size)
+        crc = table[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Header 中 headerChecksum 之前的部分
+quint32 headerCrc(const BinaryCatalog::Header& h) {
+    return crc32(reinterpret_cast<const uchar*>(&h), qint64(offsetof(BinaryCatalog::Header, headerChecksum)));
+}
+
+} // namespace
+
+BinaryCatalog::~BinaryCatalog() {
+    close();
+}
+
+void BinaryCatalog::close() {
+    if (base) file.unmap(const_cast<uchar*>(base));
+    if (file.isOpen()) file.close();
+    base = nullptr;
+    header = nullptr;
+    courses = nullptr;
+    offerings = nullptr;
+    prereqs = nullptr;
+    strings = nullptr;
+}
+
+bool BinaryCatalog::fail(const QString& message) {
+    close();
+    error = message;
+    qWarning() << "BinaryCatalog:" << message;
+    return false;
+}
+
+bool BinaryCatalog::open(const QString& filePath, Check check) {
+    close();
+    error.clear();
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return fail(QString("无法打开文件：%1").arg(filePath));
+    const qint64 size = file.size();
+    if (size < qint64(sizeof(Header)))
+        return fail(QString("文件过短：%1").arg(filePath));
+    base = file.map(0, size);
+    if (!base)
+        return fail(QString("无法映射文件：%1").arg(file.errorString()));
+    header = reinterpret_cast<const Header*>(base);
+    if (!validate(size)) return false;
+    return check == HeaderCheck || verifyChecksum();
+}
+
+bool BinaryCatalog::verifyChecksum() {
+    if (!header) return false;
+    if (crc32(base + sizeof(Header), file.size() - qint64(sizeof(Header))) != header->checksum)
+        return fail("校验和不匹配，文件可能已损坏");
+    return true;
+}
+
+bool BinaryCatalog::validate(qint64 fileSize) {
+    const Header& h = *header;
+    if (std::memcmp(h.magic, Magic, sizeof(Magic)) != 0)
+        return fail("不是课程目录文件");
+    if (h.byteOrder != ByteOrderMark)
+        return fail("字节序不匹配");
+    if (h.version != Version)
+        return fail(QString("不支持的版本 %1（需要 %2）").arg(h.version).arg(Version));
+    if (headerCrc(h) != h.headerChecksum)
+        return fail("Header 校验和不匹配，文件可能已损坏");
+
+    const quint64 size = quint64(fileSize);
+    auto sectionFits = [size](quint64 offset, quint64 count, quint64 itemSize) {
+        return offset % 8 == 0 && offset >= sizeof(Header) && offset <= size &&
+               count <= (size - offset) / itemSize;
+    };
+    if (h.courseCount > quint32(INT_MAX) || h.offeringCount > quint32(INT_MAX) ||
+        h.prereqCount > quint32(INT_MAX) ||
+        !sectionFits(h.coursesOffset, h.courseCount, sizeof(CourseRecord)) ||
+        !sectionFits(h.offeringsOffset, h.offeringCount, sizeof(OfferingRecord)) ||
+        !sectionFits(h.prereqsOffset, h.prereqCount, sizeof(PrereqRecord)) ||
+        !sectionFits(h.stringsOffset, h.stringUnits, sizeof(QChar)))
+        return fail("段长度与文件大小不符");
+
+    courses = reinterpret_cast<const CourseRecord*>(base + h.coursesOffset);
+    offerings = reinterpret_cast<const OfferingRecord*>(base + h.offeringsOffset);
+    prereqs = reinterpret_cast<const PrereqRecord*>(base + h.prereqsOffset);
+    strings = reinterpret_cast<const QChar*>(base + h.stringsOffset);
+
+    // 逐条检查区间，之后的访问无需再做边界判断
+    auto strOk = [&h](const StrRef& r) {
+        return r.offset <= h.stringUnits && r.length <= h.stringUnits - r.offset;
+    };
+    quint32 nextOffering = 0;
+    quint32 nextPrereq = 0;
+    for (quint32 c = 0; c < h.courseCount; ++c) {
+        const CourseRecord& r = courses[c];
+        if (!strOk(r.id) || !strOk(r.name) || !strOk(r.required) ||
+            r.offeringBegin != nextOffering || r.offeringEnd < r.offeringBegin ||
+            r.offeringEnd > h.offeringCount || r.prereqBegin != nextPrereq ||
+            r.prereqEnd < r.prereqBegin || r.prereqEnd > h.prereqCount)
+            return fail(QString("第 %1 条课程记录越界").arg(c));
+        for (quint32 o = r.offeringBegin; o < r.offeringEnd; ++o) {
+            const OfferingRecord& off = offerings[o];
+            if (off.course != c || !strOk(off.id) || !strOk(off.teacher))
+                return fail(QString("第 %1 条班次记录越界").arg(o));
+        }
+        for (quint32 e = r.prereqBegin; e < r.prereqEnd; ++e) {
+            const PrereqRecord& p = prereqs[e];
+            if (!strOk(p.id) || p.course < -1 || p.course >= qint32(h.courseCount))
+                return fail(QString("第 %1 条先修记录越界").arg(e));
+        }
+        nextOffering = r.offeringEnd;
+        nextPrereq = r.prereqEnd;
+    }
+    if (nextOffering != h.offeringCount || nextPrereq != h.prereqCount)
+        return fail("班次或先修记录数量不符");
+    return true;
+}
+
+QString BinaryCatalog::copy(const StrRef& ref) const {
+    return QString(strings + ref.offset, qsizetype(ref.length));
+}
+
+CourseOffering BinaryCatalog::toOffering(int offering) const {
+    const OfferingRecord& rec = offerings[offering];
+    CourseOffering off;
+    off.id = copy(rec.id);
+    off.teacher = copy(rec.teacher);
+    std::memcpy(off.times, rec.times, sizeof(off.times));
+    off.weeks = rec.weeks;
+    return off;
+}
+
+Course BinaryCatalog::toCourse(int course) const {
+    const CourseRecord& r = courses[course];
+    Course c;
+    c.id = copy(r.id);
+    c.name = copy(r.name);
+    c.credit = r.credit;
+    c.required = copy(r.required);
+    c.prerequisites.reserve(int(r.prereqEnd - r.prereqBegin));
+    for (quint32 e = r.prereqBegin; e < r.prereqEnd; ++e)
+        c.prerequisites.append(copy(prereqs[e].id));
+    c.offerings.reserve(int(r.offeringEnd - r.offeringBegin));
+    for (quint32 o = r.offeringBegin; o < r.offeringEnd; ++o)
+        c.offerings.append(toOffering(int(o)));
+    return c;
+}
+
+BinaryCatalog::Source BinaryCatalog::sourceOf(const QString& jsonPath) {
+    const QFileInfo info(jsonPath);
+    if (!info.exists()) return Source{-1, -1};
+    return Source{info.size(), info.lastModified().toMSecsSinceEpoch()};
+}
+
+QList<Course> BinaryCatalog::toCourses() const {
+    QList<Course> out;
+    out.reserve(courseCount());
+    for (int c = 0; c < courseCount(); ++c)
+        out.append(toCourse(c));
+    return out;
+}
+
+bool BinaryCatalog::write(const QList<Course>& list, const QString& filePath, const Source& source) {
+    // 字符串表去重：课程性质、教师、班次号等大量重复
+    QVector<QChar> units;
+    QHash<QString, StrRef> pool;
+    auto intern = [&](const QString& s) {
+        auto it = pool.constFind(s);
+        if (it != pool.constEnd()) return it.value();
+        StrRef ref{quint32(units.size()), quint32(s.size())};
+        units.resize(units.size() + s.size());
+        std::copy(s.constBegin(), s.constEnd(), units.begin() + ref.offset);
+        pool.insert(s, ref);
+        return ref;
+    };
+
+    QHash<QString, int> index;
+    index.reserve(list.size());
+    for (int c = 0; c < list.size(); ++c) {
+        if (!index.contains(list[c].id)) index.insert(list[c].id, c);
+    }
+
+    QVector<CourseRecord> courseRecs(list.size());
+    QVector<OfferingRecord> offeringRecs;
+    QVector<PrereqRecord> prereqRecs;
+    for (int c = 0; c < list.size(); ++c) {
+        const Course& course = list[c];
+        CourseRecord& r = courseRecs[c];
+        r.id = intern(course.id);
+        r.name = intern(course.name);
+        r.required = intern(course.required);
+        r.credit = course.credit;
+        r.offeringBegin = quint32(offeringRecs.size());
+        for (const auto& off : course.offerings) {
+            OfferingRecord o;
+            o.id = intern(off.id);
+            o.teacher = intern(off.teacher);
+            std::memcpy(o.times, off.times, sizeof(o.times));
+            o.weeks = off.weeks;
+            o.course = quint32(c);
+            offeringRecs.append(o);
+        }
+        r.offeringEnd = quint32(offeringRecs.size());
+        r.prereqBegin = quint32(prereqRecs.size());
+        for (const auto& pre : course.prerequisites)
+            prereqRecs.append(PrereqRecord{intern(pre), qint32(index.value(pre, -1))});
+        r.prereqEnd = quint32(prereqRecs.size());
+    }
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, Magic, sizeof(Magic));
+    h.version = Version;
+    h.byteOrder = ByteOrderMark;
+    h.courseCount = quint32(courseRecs.size());
+    h.offeringCount = quint32(offeringRecs.size());
+    h.prereqCount = quint32(prereqRecs.size());
+    h.stringUnits = quint32(units.size());
+    h.sourceSize = source.size;
+    h.sourceModified = source.modifiedMs;
+    h.coursesOffset = align8(sizeof(Header));
+    h.offeringsOffset = align8(h.coursesOffset + quint64(courseRecs.size()) * sizeof(CourseRecord));
+    h.prereqsOffset = align8(h.offeringsOffset + quint64(offeringRecs.size()) * sizeof(OfferingRecord));
+    h.stringsOffset = align8(h.prereqsOffset + quint64(prereqRecs.size()) * sizeof(PrereqRecord));
+    const quint64 total = h.stringsOffset + quint64(units.size()) * sizeof(QChar);
+
+    QByteArray blob(qsizetype(total), '\0');
+    char* out = blob.data();
+    std::memcpy(out + h.coursesOffset, courseRecs.constData(), courseRecs.size() * sizeof(CourseRecord));
+    std::memcpy(out + h.offeringsOffset, offeringRecs.constData(), offeringRecs.size() * sizeof(OfferingRecord));
+    std::memcpy(out + h.prereqsOffset, prereqRecs.constData(), prereqRecs.size() * sizeof(PrereqRecord));
+    std::memcpy(out + h.stringsOffset, units.constData(), units.size() * sizeof(QChar));
+    h.checksum = crc32(reinterpret_cast<const uchar*>(out) + sizeof(Header),
+                       qint64(total) - qint64(sizeof(Header)));
+    h.headerChecksum = headerCrc(h);
+    std::memcpy(out, &h, sizeof(h));
+
+    // QSaveFile 先写临时文件再原子替换，避免留下半个目录文件
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法写入文件：" << filePath;
+        return false;
+    }
+    if (file.write(blob) != blob.size() || !file.commit()) {
+        qWarning() << "写入课程目录失败：" << filePath << file.errorString();
+        return false;
+    }
+    return true;
+}
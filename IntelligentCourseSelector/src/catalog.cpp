@@ -0,0 +1,198 @@
+#include "catalog.h"
+#include "binarycatalog.h"
+#include <QDebug>
+
+CourseCatalog::CourseCatalog(const QList<Course>& courses, std::shared_ptr<const StringPool> strings)
+    : pool(std::move(strings))
+{
+    // 课程列表拆成列后不再保留；字符串隐式共享，拆列时不复制字符数据
+    const int n = courses.size();
+    idToCourse.reserve(n);
+    credits.resize(n);
+    compulsory.resize(n);
+    offeringStart.resize(n + 1);
+    prereqStart.resize(n + 1);
+    unresolved.fill(false, n);
+    text.courseIds.resize(n);
+    text.names.resize(n);
+    text.required.resize(n);
+    text.prereqIdStart.resize(n + 1);
+
+    int next = 0;
+    for (int c = 0; c < n; ++c) {
+        const Course& course = courses[c];
+        if (idToCourse.contains(course.id)) {
+            qWarning() << "CourseCatalog: 重复的课程ID" << course.id;
+        } else {
+            idToCourse.insert(course.id, c);
+        }
+        credits[c] = course.credit;
+        compulsory[c] = course.required == "Compulsory";
+        text.courseIds[c] = course.id;
+        text.names[c] = course.name;
+        text.required[c] = course.required;
+        text.prereqIdStart[c] = text.prereqIds.size();
+        text.prereqIds.append(course.prerequisites);
+        offeringStart[c] = next;
+        next += course.offerings.size();
+    }
+    offeringStart[n] = next;
+    text.prereqIdStart[n] = text.prereqIds.size();
+
+    offeringToCourse.resize(next);
+    offeringMasks.resize(next);
+    offeringWeekMasks.resize(next);
+    text.offeringIds.resize(next);
+    text.teachers.resize(next);
+    for (int c = 0; c < n; ++c) {
+        const auto& offs = courses[c].offerings;
+        for (int i = 0; i < offs.size(); ++i) {
+            const int o = offeringStart[c] + i;
+            offeringToCourse[o] = c;
+            offeringMasks[o] = SlotMask::fromTimes(offs[i].times);
+            offeringWeekMasks[o] = offs[i].weeks;
+            text.offeringIds[o] = offs[i].id;
+            text.teachers[o] = offs[i].teacher;
+        }
+    }
+
+    // 先修课程在全部课程驻留之后再解析，允许引用后出现的课程
+    for (int c = 0; c < n; ++c) {
+        prereqStart[c] = prereqList.size();
+        for (const auto& pre : courses[c].prerequisites)
+            addPrerequisite(c, pre, courseIndex(pre));
+    }
+    prereqStart[n] = prereqList.size();
+}
+
+CourseCatalog::CourseCatalog(std::shared_ptr<const BinaryCatalog> bin)
+    : binary(std::move(bin))
+{
+    // 各列按记录顺序批量填充；ID 键直接引用映射内存，不做字符串拷贝
+    const BinaryCatalog& b = *binary;
+    const int n = b.courseCount();
+    idToCourse.reserve(n);
+    credits.resize(n);
+    compulsory.resize(n);
+    offeringStart.resize(n + 1);
+    prereqStart.resize(n + 1);
+    unresolved.fill(false, n);
+    offeringToCourse.resize(b.offeringCount());
+    offeringMasks.resize(b.offeringCount());
+    offeringWeekMasks.resize(b.offeringCount());
+    prereqList.reserve(b.prereqCount());
+
+    for (int c = 0; c < n; ++c) {
+        const auto& r = b.courseRecord(c);
+        const QString id = b.string(r.id);
+        if (idToCourse.contains(id)) {
+            qWarning() << "CourseCatalog: 重复的课程ID" << id;
+        } else {
+            idToCourse.insert(id, c);
+        }
+        credits[c] = r.credit;
+        compulsory[c] = b.string(r.required) == "Compulsory";
+        offeringStart[c] = int(r.offeringBegin);
+        for (quint32 o = r.offeringBegin; o < r.offeringEnd; ++o) {
+            offeringToCourse[o] = c;
+            offeringMasks[o] = SlotMask::fromTimes(b.offeringRecord(o).times);
+            offeringWeekMasks[o] = b.offeringRecord(o).weeks;
+        }
+    }
+    offeringStart[n] = b.offeringCount();
+
+    // 先修下标在编译时已解析，这里只需跳过未解析项
+    for (int c = 0; c < n; ++c) {
+        const auto& r = b.courseRecord(c);
+        prereqStart[c] = prereqList.size();
+        for (quint32 e = r.prereqBegin; e < r.prereqEnd; ++e) {
+            const auto& p = b.prereqRecord(e);
+            addPrerequisite(c, b.string(p.id), p.course);
+        }
+    }
+    prereqStart[n] = prereqList.size();
+}
+
+void CourseCatalog::addPrerequisite(int course, const QString& pre, int resolved) {
+    if (resolved < 0) {
+        qWarning() << "CourseCatalog: 未知的先修课程" << pre << "in course" << courseId(course);
+        unresolved[course] = true;
+        return;
+    }
+    prereqList.append(resolved);
+}
+
+QString CourseCatalog::courseId(int course) const {
+    if (binary) return binary->string(binary->courseRecord(course).id);
+    return text.courseIds[course];
+}
+
+QString CourseCatalog::courseName(int course) const {
+    if (binary) return binary->string(binary->courseRecord(course).name);
+    return text.names[course];
+}
+
+QString CourseCatalog::courseRequired(int course) const {
+    if (binary) return binary->string(binary->courseRecord(course).required);
+    return text.required[course];
+}
+
+QString CourseCatalog::offeringId(int offering) const {
+    if (binary) return binary->string(binary->offeringRecord(offering).id);
+    return text.offeringIds[offering];
+}
+
+QString CourseCatalog::offeringTeacher(int offering) const {
+    if (binary) return binary->string(binary->offeringRecord(offering).teacher);
+    return text.teachers[offering];
+}
+
+QStringList CourseCatalog::prerequisiteIds(int course) const {
+    QStringList ids;
+    if (binary) {
+        const auto& r = binary->courseRecord(course);
+        for (quint32 e = r.prereqBegin; e < r.prereqEnd; ++e)
+            ids.append(binary->string(binary->prereqRecord(e).id));
+        return ids;
+    }
+    for (int e = text.prereqIdStart[course]; e < text.prereqIdStart[course + 1]; ++e)
+        ids.append(text.prereqIds[e]);
+    return ids;
+}
+
+Course CourseCatalog::course(int course) const {
+    if (binary) return binary->toCourse(course);
+    Course c;
+    c.id = text.courseIds[course];
+    c.name = text.names[course];
+    c.credit = credits[course];
+    c.required = text.required[course];
+    c.prerequisites = prerequisiteIds(course);
+    c.offerings.reserve(offeringEnd(course) - offeringBegin(course));
+    for (int o = offeringBegin(course); o < offeringEnd(course); ++o)
+        c.offerings.append(offering(o));
+    return c;
+}
+
+CourseOffering CourseCatalog::offering(int offering) const {
+    if (binary) return binary->toOffering(offering);
+    CourseOffering off;
+    off.id = text.offeringIds[offering];
+    off.teacher = text.teachers[offering];
+    for (int d = 0; d < 7; ++d)
+        off.times[d] = offeringMasks[offering].day[d];
+    off.weeks = offeringWeekMasks[offering];
+    return off;
+}
+
+int CourseCatalog::courseIndex(const QString& courseId) const {
+    return idToCourse.value(courseId, -1);
+}
+
+int CourseCatalog::offeringIndex(int course, const QString& offeringId) const {
+    if (course < 0 || course >= courseCount()) return -1;
+    for (int o = offeringBegin(course); o < offeringEnd(course); ++o) {
+        if (this->offeringId(o) == offeringId) return o;
+    }
+    return -1;
+}
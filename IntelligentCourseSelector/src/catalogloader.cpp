@@ -0,0 +1,60 @@
+#include "catalogloader.h"
+#include "binarycatalog.h"
+#include "jsonparser.h"
+#include "stringpool.h"
+#include <QThread>
+
+CatalogLoader::CatalogLoader(const QString& filePath, QObject* parent)
+    : QObject(parent),
+    path(filePath)
+{
+}
+
+CatalogLoader::~CatalogLoader() {
+    abortRequested.store(true);
+    if (thread) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+void CatalogLoader::start() {
+    if (thread) return;
+    thread = QThread::create([this] { run(); });
+    thread->start();
+}
+
+std::unique_ptr<ScheduleManager> CatalogLoader::takeManager() {
+    return std::move(manager);
+}
+
+CourseSearchIndex CatalogLoader::takeSearchIndex() {
+    return std::move(searchIndex);
+}
+
+void CatalogLoader::run() {
+    JsonParser parser;   // 解析器不含共享状态，加载线程使用自己的实例
+    // 有最新的二进制目录时，排课直接建在映射内存上，不再逐条解析 JSON
+    if (auto binary = parser.openBinaryCatalog(path)) {
+        manager.reset(new ScheduleManager(CourseCatalog(binary)));
+        searchIndex = CourseSearchIndex(manager->getCatalog());
+        emit finished(true);
+        return;
+    }
+
+    // 课程文本驻留在字符串池中，池随目录一起交给排课器（加载失败时由空目录持有），
+    // 分批发给界面的课程同样引用池，在排课器存在期间一直有效
+    auto pool = std::make_shared<StringPool>();
+    QList<Course> courses;
+    const bool ok = parser.parseCourseJsonStream(path, ChunkSize, [this, &courses](const QList<Course>& chunk) {
+        if (abortRequested.load()) return false;
+        courses += chunk;
+        emit coursesLoaded(chunk);
+        return true;
+    }, pool.get());
+    if (abortRequested.load()) return;
+    // 失败时与同步加载一致：使用空目录，界面照常可用
+    manager.reset(new ScheduleManager(CourseCatalog(ok ? courses : QList<Course>(), pool)));
+    searchIndex = CourseSearchIndex(manager->getCatalog());
+    emit finished(ok);
+}
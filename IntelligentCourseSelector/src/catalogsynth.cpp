@@ -0,0 +1,161 @@
+#include "catalogsynth.h"
+#include "catalog.h"
+#include "prereqgraph.h"
+#include <QSet>
+#include <QChar>
+#include <QRandomGenerator>
+#include <QDebug>
+#include <algorithm>
+
+CatalogProfile CatalogProfile::fromCourses(const QList<Course>& courses) {
+    return fromCatalog(CourseCatalog(courses));
+}
+
+CatalogProfile CatalogProfile::fromCatalog(const CourseCatalog& catalog) {
+    CatalogProfile prof;
+    if (catalog.courseCount() == 0) return prof;
+
+    // 最长先修链深度：沿拓扑序递推，成环或先修未知的课程记为 0
+    const PrereqGraph graph(catalog);
+    QVector<int> order;
+    graph.sort(order);
+    QVector<int> depth(catalog.courseCount(), 0);
+    for (int c : order) {
+        for (int pre : graph.prerequisites(c))
+            depth[c] = qMax(depth[c], depth[pre] + 1);
+    }
+
+    QSet<QString> teachers;
+    QSet<QString> prefixes;
+    int compulsory = 0;
+    int offeringTotal = 0;
+    for (int c = 0; c < catalog.courseCount(); ++c) {
+        const Course& course = catalog.course(c);
+        prof.credits.append(course.credit);
+        prof.offeringCounts.append(course.offerings.size());
+        prof.depths.append(depth[c]);
+        if (!course.prerequisites.isEmpty())
+            prof.prereqCounts.append(course.prerequisites.size());
+        if (course.required == "Compulsory") ++compulsory;
+        prof.names.append(course.name);
+
+        int letters = 0;
+        while (letters < course.id.size() && course.id.at(letters).isLetter()) ++letters;
+        if (letters > 0) prefixes.insert(course.id.left(letters));
+
+        for (const auto& off : course.offerings) {
+            int active = 0;
+            for (int d = 0; d < 7; ++d) {
+                if (off.times[d] == 0) continue;
+                ++active;
+                prof.days.append(d);
+                prof.dayMasks.append(off.times[d]);
+            }
+            if (active > 0) prof.activeDays.append(active);
+            prof.weekMasks.append(off.weeks);
+            teachers.insert(off.teacher);
+            ++offeringTotal;
+        }
+    }
+
+    prof.idPrefixes = QStringList(prefixes.cbegin(), prefixes.cend());
+    std::sort(prof.idPrefixes.begin(), prof.idPrefixes.end());
+    if (prof.idPrefixes.isEmpty()) prof.idPrefixes.append("SYNC");
+    if (prof.prereqCounts.isEmpty()) prof.prereqCounts.append(1);
+    if (prof.weekMasks.isEmpty()) prof.weekMasks.append(CourseOffering::AllWeeks);
+    if (prof.activeDays.isEmpty()) {
+        prof.activeDays.append(1);
+        prof.days.append(0);
+        prof.dayMasks.append(3);
+    }
+    prof.compulsoryRatio = double(compulsory) / catalog.courseCount();
+    if (offeringTotal > 0)
+        prof.teachersPerOffering = double(teachers.size()) / offeringTotal;
+    return prof;
+}
+
+int CatalogProfile::maxDepth() const {
+    int d = 0;
+    for (int v : depths) d = qMax(d, v);
+    return d;
+}
+
+namespace {
+
+template <typename List>
+const typename List::value_type& pick(const List& pool, QRandomGenerator& rng) {
+    return pool[rng.bounded(int(pool.size()))];
+}
+
+} // namespace
+
+QList<Course> synthesizeCatalog(const CatalogProfile& prof, int count, quint32 seed) {
+    QList<Course> out;
+    if (prof.isEmpty() || count <= 0) {
+        qWarning() << "synthesizeCatalog: 空的课程分布或课程数" << count;
+        return out;
+    }
+    QRandomGenerator rng(seed);
+
+    // 先抽样每门课的目标深度并按深度排序，逐层生成；
+    // 某一层为空时把更深的课程压到下一层，保证每条链都能接上
+    QVector<int> depths(count);
+    for (int& d : depths) d = pick(prof.depths, rng);
+    std::sort(depths.begin(), depths.end());
+
+    qint64 offeringSum = 0;
+    for (int k : prof.offeringCounts) offeringSum += k;
+    const double meanOfferings = double(offeringSum) / prof.offeringCounts.size();
+    const int teacherPool = qMax(1, int(prof.teachersPerOffering * meanOfferings * count));
+
+    out.reserve(count);
+    QVector<int> levelStart;     // 层 -> 该层第一门课的下标
+    for (int i = 0; i < count; ++i) {
+        int d = qMin(depths[i], int(levelStart.size()));
+        if (d == levelStart.size()) levelStart.append(i);
+
+        Course c;
+        c.id = QString("%1%2").arg(pick(prof.idPrefixes, rng)).arg(i, 10, 10, QChar('0'));
+        c.name = QString("%1（%2）").arg(pick(prof.names, rng)).arg(i);
+        c.credit = pick(prof.credits, rng);
+        c.required = rng.generateDouble() < prof.compulsoryRatio ? "Compulsory" : "Elective";
+
+        if (d > 0) {
+            // 至少一门先修课来自上一层，其余来自任意更浅的层
+            const int prevBegin = levelStart[d - 1];
+            const int prevEnd = levelStart[d];
+            const int want = qMax(1, pick(prof.prereqCounts, rng));
+            QSet<int> chosen;
+            chosen.insert(prevBegin + rng.bounded(prevEnd - prevBegin));
+            for (int tries = 0; chosen.size() < want && tries < want * 4; ++tries)
+                chosen.insert(rng.bounded(prevEnd));
+            QVector<int> pres(chosen.cbegin(), chosen.cend());
+            std::sort(pres.begin(), pres.end());
+            for (int p : pres) c.prerequisites.append(out[p].id);
+        }
+
+        const int offerings = qMax(1, pick(prof.offeringCounts, rng));
+        int firstId = 1 + rng.bounded(qMax(1, 99 - offerings));
+        for (int k = 0; k < offerings; ++k) {
+            CourseOffering off;
+            off.id = QString("%1").arg(firstId + k, 2, 10, QChar('0'));
+            off.teacher = QString("教师%1").arg(rng.bounded(teacherPool));
+            std::fill(off.times, off.times + 7, 0u);
+            const int active = qMin(7, pick(prof.activeDays, rng));
+            for (int n = 0, tries = 0; n < active && tries < 32; ++tries) {
+                int day = pick(prof.days, rng);
+                if (off.times[day] != 0) continue;
+                off.times[day] = pick(prof.dayMasks, rng);
+                ++n;
+            }
+            off.weeks = pick(prof.weekMasks, rng);
+            c.offerings.append(off);
+        }
+        out.append(c);
+    }
+
+    // 打乱输出顺序，避免文件顺序恰好就是拓扑序
+    for (int i = out.size() - 1; i > 0; --i)
+        out.swapItemsAt(i, rng.bounded(i + 1));
+    return out;
+}
@@ -42,6 +42,21 @@ QString CourseOffering::timeSlotsToString() const {
     return parts.join("; ");
 }
 
+// 将上课周转换为可读字符串，连续的周合并为区间
+QString CourseOffering::weeksToString() const {
+    if (weeks == AllWeeks) return "每周";
+    if (weeks == 0) return "无";
+    QStringList parts;
+    for (int w = 0; w < 32; ++w) {
+        if (!(weeks & (1u << w))) continue;
+        int end = w;
+        while (end + 1 < 32 && (weeks & (1u << (end + 1)))) ++end;
+        parts.append(end > w ? QString("%1-%2").arg(w + 1).arg(end + 1) : QString::number(w + 1));
+        w = end;
+    }
+    return "第" + parts.join(",") + "周";
+}
+
 // 获取指定班次信息
 const CourseOffering& Course::getOffering(const QString& offeringId) const {
     static CourseOffering emptyOffering;
@@ -0,0 +1,98 @@
+#include "coursesearchindex.h"
+#include <QStringList>
+#include <algorithm>
+
+namespace {
+// 字段分隔符：查询经 simplified() 后不含换行，n-gram 跨字段也不会被命中
+const QChar FieldSeparator('\n');
+}
+
+CourseSearchIndex::CourseSearchIndex(const CourseCatalog& catalog) {
+    const int n = catalog.courseCount();
+    texts.resize(n);
+
+    // 先收集 (gram, 课程) 对，排序去重后一次性建成 CSR
+    QVector<quint64> pairs;
+    for (int c = 0; c < n; ++c) {
+        QString text = catalog.courseName(c) + FieldSeparator + catalog.courseId(c);
+        for (int o = catalog.offeringBegin(c); o < catalog.offeringEnd(c); ++o) {
+            text += FieldSeparator;
+            text += catalog.offeringTeacher(o);
+        }
+        text = text.toCaseFolded();
+        for (int i = 0; i < text.size(); ++i) {
+            if (text[i] == FieldSeparator) continue;
+            pairs.append((quint64(gram(text[i])) << 32) | quint32(c));
+            if (i + 1 < text.size() && text[i + 1] != FieldSeparator)
+                pairs.append((quint64(gram(text[i], text[i + 1])) << 32) | quint32(c));
+        }
+        texts[c] = std::move(text);
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    postings.reserve(pairs.size());
+    for (quint64 p : pairs) {
+        const quint32 g = quint32(p >> 32);
+        if (grams.isEmpty() || grams.last() != g) {
+            grams.append(g);
+            start.append(postings.size());
+        }
+        postings.append(int(quint32(p)));
+    }
+    start.append(postings.size());
+}
+
+IndexRange CourseSearchIndex::postingsOf(quint32 g) const {
+    const auto it = std::lower_bound(grams.begin(), grams.end(), g);
+    if (it == grams.end() || *it != g) return IndexRange{};
+    const int k = int(it - grams.begin());
+    const int* base = postings.constData();
+    return IndexRange{base + start[k], base + start[k + 1]};
+}
+
+// 候选集为关键词各二元 gram 倒排表的交集（单字关键词直接取一元倒排表），
+// 长度超过 2 的关键词再对候选做一次子串校验
+void CourseSearchIndex::matchTerm(const QString& term, QVector<int>& result, bool first) const {
+    QVector<IndexRange> lists;
+    if (term.size() == 1) {
+        lists.append(postingsOf(gram(term[0])));
+    } else {
+        for (int i = 0; i + 1 < term.size(); ++i)
+            lists.append(postingsOf(gram(term[i], term[i + 1])));
+    }
+    // 从最短的表开始求交，中间结果始终不超过最短表
+    std::sort(lists.begin(), lists.end(), [](const IndexRange& a, const IndexRange& b) {
+        return a.size() < b.size();
+    });
+    QVector<int> cur;
+    if (first) {
+        cur = QVector<int>(lists[0].begin(), lists[0].end());
+        lists.removeFirst();
+    } else {
+        cur = result;
+    }
+    QVector<int> next;
+    for (const IndexRange& r : lists) {
+        if (cur.isEmpty()) break;
+        next.clear();
+        std::set_intersection(cur.begin(), cur.end(), r.begin(), r.end(), std::back_inserter(next));
+        cur.swap(next);
+    }
+    if (term.size() > 2) {
+        cur.erase(std::remove_if(cur.begin(), cur.end(), [this, &term](int c) {
+            return !texts[c].contains(term);
+        }), cur.end());
+    }
+    result = std::move(cur);
+}
+
+QVector<int> CourseSearchIndex::search(const QString& query) const {
+    QVector<int> result;
+    const QStringList terms = query.simplified().toCaseFolded().split(' ', Qt::SkipEmptyParts);
+    for (int i = 0; i < terms.size(); ++i) {
+        matchTerm(terms[i], result, i == 0);
+        if (result.isEmpty()) break;
+    }
+    return result;
+}
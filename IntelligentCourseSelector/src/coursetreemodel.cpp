@@ -0,0 +1,159 @@
+#include "coursetreemodel.h"
+#include <QStringList>
+
+namespace {
+const char* const GroupNames[2] = {"必修课程", "选修课程"};
+}
+
+CourseTreeModel::CourseTreeModel(const CourseCatalog* cat, QObject* parent)
+    : QAbstractItemModel(parent),
+    catalog(cat)
+{
+    rebuildGroups();
+}
+
+// 每门课程只占分类表中的一个 int；分类结果缓存在 groupOf 中，过滤时不再比较字符串
+void CourseTreeModel::rebuildGroups() {
+    const int n = catalog ? catalog->courseCount() : staged.size();
+    groupOf.resize(n);
+    for (int c = 0; c < n; ++c) {
+        const bool required = catalog ? catalog->isCompulsory(c) : staged[c].required == "Compulsory";
+        groupOf[c] = required ? 0 : 1;
+    }
+    filtered = false;
+    groups[0].clear();
+    groups[1].clear();
+    for (int c = 0; c < n; ++c)
+        groups[groupOf[c]].append(c);
+}
+
+void CourseTreeModel::setFilter(const QVector<int>& courses) {
+    beginResetModel();
+    filtered = true;
+    groups[0].clear();
+    groups[1].clear();
+    for (int c : courses)
+        groups[groupOf[c]].append(c);
+    endResetModel();
+}
+
+void CourseTreeModel::clearFilter() {
+    if (!filtered) return;
+    beginResetModel();
+    filtered = false;
+    groups[0].clear();
+    groups[1].clear();
+    for (int c = 0; c < groupOf.size(); ++c)
+        groups[groupOf[c]].append(c);
+    endResetModel();
+}
+
+void CourseTreeModel::appendCourses(const QList<Course>& chunk) {
+    if (catalog || filtered || chunk.isEmpty()) return;
+    QVector<int> added[2];
+    for (int i = 0; i < chunk.size(); ++i) {
+        const quint8 g = chunk[i].required == "Compulsory" ? 0 : 1;
+        groupOf.append(g);
+        added[g].append(staged.size() + i);
+    }
+    staged.append(chunk);
+    for (int g = 0; g < 2; ++g) {
+        if (added[g].isEmpty()) continue;
+        const int first = groups[g].size();
+        beginInsertRows(index(g, 0), first, first + added[g].size() - 1);
+        groups[g] += added[g];
+        endInsertRows();
+    }
+}
+
+void CourseTreeModel::setCatalog(const CourseCatalog* cat) {
+    // 目录由同一份解析结果按顺序建立时，行与下标都不变，无需通知视图
+    if (cat && !catalog && cat->courseCount() == staged.size()) {
+        catalog = cat;
+        staged.clear();
+        return;
+    }
+    beginResetModel();
+    catalog = cat;
+    staged.clear();
+    rebuildGroups();
+    endResetModel();
+}
+
+QModelIndex CourseTreeModel::index(int row, int column, const QModelIndex& parent) const {
+    if (column != 0 || row < 0) return QModelIndex();
+    if (!parent.isValid())
+        return row < 2 ? createIndex(row, 0, quintptr(0)) : QModelIndex();
+    if (parent.internalId() != 0) return QModelIndex();
+    const int g = parent.row();
+    return row < groups[g].size() ? createIndex(row, 0, quintptr(g + 1)) : QModelIndex();
+}
+
+QModelIndex CourseTreeModel::parent(const QModelIndex& child) const {
+    if (!child.isValid() || child.internalId() == 0) return QModelIndex();
+    return createIndex(int(child.internalId()) - 1, 0, quintptr(0));
+}
+
+int CourseTreeModel::rowCount(const QModelIndex& parent) const {
+    if (!parent.isValid()) return 2;
+    if (parent.internalId() == 0) return groups[parent.row()].size();
+    return 0;
+}
+
+int CourseTreeModel::columnCount(const QModelIndex&) const {
+    return 1;
+}
+
+int CourseTreeModel::courseAt(const QModelIndex& index) const {
+    if (!index.isValid() || index.internalId() == 0) return -1;
+    return groups[index.internalId() - 1][index.row()];
+}
+
+QVariant CourseTreeModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) return QVariant();
+    const int c = courseAt(index);
+    if (c < 0) {
+        if (role == Qt::DisplayRole) return QString(GroupNames[index.row()]);
+        if (role == CourseIndexRole) return -1;
+        return QVariant();
+    }
+    switch (role) {
+    case Qt::DisplayRole:
+        return catalog ? catalog->courseName(c) : staged[c].name;
+    case Qt::ToolTipRole:
+        if (!catalog)
+            return QString("学分：%1\n类型：%2").arg(staged[c].credit).arg(staged[c].required);
+        return QString("学分：%1\n类型：%2").arg(catalog->credit(c)).arg(catalog->courseRequired(c));
+    case CourseIdRole:
+        return catalog ? catalog->courseId(c) : staged[c].id;
+    case CourseIndexRole:
+        return c;
+    default:
+        return QVariant();
+    }
+}
+
+QVariant CourseTreeModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (section == 0 && orientation == Qt::Horizontal && role == Qt::DisplayRole)
+        return QString("课程分类");
+    return QVariant();
+}
+
+QList<QPair<QString, QString>> CourseTreeModel::details(const QModelIndex& index) const {
+    QList<QPair<QString, QString>> rows;
+    const int c = courseAt(index);
+    if (c < 0) return rows;
+    const Course course = catalog ? catalog->course(c) : staged[c];
+    rows.append({"ID", course.id});
+    rows.append({"名称", course.name});
+    rows.append({"学分", QString::number(course.credit)});
+    rows.append({"类型", QString(course.required == "Compulsory" ? "必修" : "选修")});
+    rows.append({"先修课程", course.prerequisites.join("，")});
+    for (const auto& o : course.offerings) {
+        rows.append({"班次", o.id});
+        rows.append({"教师", o.teacher});
+        rows.append({"时间", o.timeSlotsToString()});
+        rows.append({"周次", o.weeksToString()});
+    }
+    return rows;
+}
@@ -1,11 +1,348 @@
 #include "jsonparser.h"
+#include "binarycatalog.h"
+#include "stringpool.h"
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QDebug>
+#include <functional>
+#include <string>
+#include <vector>
+#include "nlohmann/json.hpp"
+
+namespace {
+
+using json = nlohmann::json;
+
+// 流式解析 course.json：直接把 SAX 事件写入 Course / CourseOffering，
+// 不构建中间 DOM；格式不符的单条记录报告后跳过，语法错误则整体失败
+class CourseSaxHandler final : public nlohmann::json_sax<json> {
+public:
+    CourseSaxHandler(QList<Course>& out, std::function<void(const QString&)> onError,
+                     StringPool* pool = nullptr)
+        : courses(out), reportError(std::move(onError)), pool(pool) {}
+
+    // 分批交出：courses 每攒满 size 门课程调用一次 onChunk 并清空，onChunk 返回 false 时中止解析
+    void setChunking(int size, std::function<bool(const QList<Course>&)> onChunk) {
+        chunkSize = size;
+        chunkReady = std::move(onChunk);
+    }
+    bool flushChunk() {
+        if (courses.isEmpty() || !chunkReady) return true;
+        stopped = !chunkReady(courses);
+        courses.clear();
+        return !stopped;
+    }
+    bool wasStopped() const { return stopped; }
+
+    bool null() override { return scalar(Value{}); }
+    bool boolean(bool) override { return scalar(Value{}); }
+    bool number_integer(number_integer_t v) override { return scalar(Value{true, qint64(v)}); }
+    bool number_unsigned(number_unsigned_t v) override { return scalar(Value{true, qint64(v)}); }
+    bool number_float(number_float_t v, const string_t&) override {
+        // 与 QJsonValue::toInt 一致，只接受整数值的浮点数
+        return scalar(v == qint64(v) ? Value{true, qint64(v)} : Value{});
+    }
+    bool string(string_t& v) override { return scalar(Value{false, 0, &v}); }
+    bool binary(binary_t&) override { return scalar(Value{}); }
+
+    bool key(string_t& k) override {
+        field = k;
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        switch (top()) {
+        case Ctx::None:
+            reportError("课程文件顶层必须是数组");
+            return false;
+        case Ctx::CourseList:
+            current = Course();
+            current.credit = 0;
+            recordError.clear();
+            ++record;
+            stack.push_back(Ctx::Course);
+            return true;
+        case Ctx::Offerings:
+            offering = CourseOffering();
+            std::fill(offering.times, offering.times + 7, 0u);
+            stack.push_back(Ctx::Offering);
+            return true;
+        default:
+            if (expectsValue()) typeError();
+            stack.push_back(Ctx::Skip);
+            return true;
+        }
+    }
+
+    bool end_object() override {
+        const Ctx ctx = pop();
+        if (ctx == Ctx::Course) {
+            if (recordError.isEmpty() && current.id.isEmpty())
+                recordError = "缺少课程ID";
+            if (recordError.isEmpty()) {
+                courses.append(std::move(current));
+                if (chunkSize > 0 && courses.size() >= chunkSize) return flushChunk();
+            } else
+                reportError(QString("第 %1 条课程记录%2已跳过：%3")
+                                .arg(record)
+                                .arg(current.id.isEmpty() ? QString() : "（" + current.id + "）")
+                                .arg(recordError));
+        } else if (ctx == Ctx::Offering) {
+            current.offerings.append(std::move(offering));
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        Ctx next = Ctx::Skip;
+        switch (top()) {
+        case Ctx::None:
+            next = Ctx::CourseList;
+            break;
+        case Ctx::Course:
+            if (field == "prerequisites") next = Ctx::Prereqs;
+            else if (field == "offerings") next = Ctx::Offerings;
+            else if (expectsValue()) typeError();
+            break;
+        case Ctx::Offering:
+            if (field == "times") {
+                next = Ctx::Times;
+                timeIndex = 0;
+            } else if (expectsValue()) {
+                typeError();
+            }
+            break;
+        default:
+            if (expectsValue()) typeError();
+            break;
+        }
+        stack.push_back(next);
+        return true;
+    }
+
+    bool end_array() override {
+        pop();
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string&,
+                     const nlohmann::detail::exception& ex) override {
+        reportError(QString("第 %1 字节处语法错误：%2").arg(quint64(position)).arg(QString::fromUtf8(ex.what())));
+        return false;
+    }
+
+private:
+    enum class Ctx { None, CourseList, Course, Prereqs, Offerings, Offering, Times, Skip };
+
+    // 标量事件的统一表示：整数或字符串，其余类型两者皆否
+    struct Value {
+        bool isInt = false;
+        qint64 i = 0;
+        const std::string* s = nullptr;
+    };
+
+    QString text(const std::string& s) {
+        return pool ? pool->internUtf8(s.data(), qsizetype(s.size())) : QString::fromStdString(s);
+    }
+
+    Ctx top() const { return stack.empty() ? Ctx::None : stack.back(); }
+    Ctx pop() {
+        Ctx c = top();
+        if (!stack.empty()) stack.pop_back();
+        return c;
+    }
+
+    // 当前位置是否是需要解析的值（未知字段与被跳过的子树不检查类型）
+    bool expectsValue() const {
+        switch (top()) {
+        case Ctx::Course:
+            return field == "id" || field == "name" || field == "credit" || field == "required" ||
+                   field == "prerequisites" || field == "offerings";
+        case Ctx::Offering:
+            return field == "id" || field == "teacher" || field == "times" || field == "weeks";
+        case Ctx::CourseList:
+        case Ctx::Prereqs:
+        case Ctx::Offerings:
+        case Ctx::Times:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // 每条记录只保留第一个错误
+    void typeError() {
+        const Ctx ctx = top();
+        if (ctx == Ctx::CourseList) {
+            reportError(QString("第 %1 条课程记录不是对象，已跳过").arg(++record));
+            return;
+        }
+        if (!recordError.isEmpty()) return;
+        const QString name = ctx == Ctx::Prereqs   ? QString("prerequisites")
+                             : ctx == Ctx::Offerings ? QString("offerings")
+                             : ctx == Ctx::Times     ? QString("times")
+                                                     : QString::fromStdString(field);
+        recordError = QString("字段 %1 类型错误").arg(name);
+    }
+
+    bool scalar(const Value& v) {
+        switch (top()) {
+        case Ctx::None:
+            reportError("课程文件顶层必须是数组");
+            return false;
+        case Ctx::CourseList:
+            typeError();
+            break;
+        case Ctx::Course:
+            if (field == "id" || field == "name" || field == "required") {
+                if (!v.s) { typeError(); break; }
+                QString str = text(*v.s);
+                if (field == "id") current.id = std::move(str);
+                else if (field == "name") current.name = std::move(str);
+                else current.required = std::move(str);
+            } else if (field == "credit") {
+                if (!v.isInt) { typeError(); break; }
+                current.credit = int(v.i);
+            } else if (expectsValue()) {
+                typeError();
+            }
+            break;
+        case Ctx::Prereqs:
+            if (!v.s) { typeError(); break; }
+            current.prerequisites.append(text(*v.s));
+            break;
+        case Ctx::Offering:
+            if (field == "id" || field == "teacher") {
+                if (!v.s) { typeError(); break; }
+                (field == "id" ? offering.id : offering.teacher) = text(*v.s);
+            } else if (field == "weeks") {
+                if (!v.isInt) { typeError(); break; }
+                offering.weeks = static_cast<quint32>(v.i);
+            } else if (expectsValue()) {
+                typeError();
+            }
+            break;
+        case Ctx::Offerings:
+            typeError();
+            break;
+        case Ctx::Times:
+            if (!v.isInt) { typeError(); break; }
+            if (timeIndex < 7) offering.times[timeIndex] = static_cast<quint32>(v.i);
+            ++timeIndex;
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    QList<Course>& courses;
+    std::function<void(const QString&)> reportError;
+    StringPool* pool;           // 为空时每个字符串各自分配
+    int chunkSize = 0;
+    std::function<bool(const QList<Course>&)> chunkReady;
+    bool stopped = false;
+    std::vector<Ctx> stack;
+    std::string field;          // 当前对象中最近一次读到的键
+    Course current;
+    CourseOffering offering;
+    QString recordError;
+    int record = 0;             // 课程记录序号（从 1 开始）
+    int timeIndex = 0;
+};
+
+} // namespace
+
+QString JsonParser::binaryCatalogPath(const QString& jsonPath) {
+    const QFileInfo info(jsonPath);
+    return info.dir().filePath(info.completeBaseName() + ".cscat");
+}
+
+std::shared_ptr<const BinaryCatalog> JsonParser::openBinaryCatalog(const QString& jsonPath) {
+    const QFileInfo json(jsonPath);
+    const QFileInfo bin(binaryCatalogPath(jsonPath));
+    if (!bin.exists()) return nullptr;
+    // JSON 被修改过则二进制目录已过期，回退到解析 JSON。
+    // 先用文件时间排除明显过期的目录，免得为它做一次完整校验
+    auto stale = [&jsonPath]() -> std::shared_ptr<const BinaryCatalog> {
+        qWarning() << "二进制课程目录已过期，改为解析：" << jsonPath;
+        return nullptr;
+    };
+    if (json.exists() && bin.lastModified() < json.lastModified()) return stale();
+    auto binary = std::make_shared<BinaryCatalog>();
+    if (!binary->open(bin.filePath())) return nullptr;
+    if (json.exists()) {
+        // 文件时间精度可能只有秒级，编辑后两者相等很常见，因此以编译时记录的来源为准；
+        // 未记录来源的目录只在严格更新时才使用
+        const BinaryCatalog::Source source = binary->source();
+        if (source.size < 0 ? !(json.lastModified() < bin.lastModified())
+                            : source != BinaryCatalog::sourceOf(jsonPath))
+            return stale();
+    }
+    return binary;
+}
+
+CourseCatalog JsonParser::loadCourseCatalog(const QString& filePath) {
+    if (auto binary = openBinaryCatalog(filePath))
+        return CourseCatalog(binary);
+    auto pool = std::make_shared<StringPool>();
+    const QList<Course> courses = parseCourseJsonStream(filePath, pool.get());
+    return CourseCatalog(courses, pool);
+}
 
 QList<Course> JsonParser::parseCourseJson(const QString& filePath) {
+    if (auto binary = openBinaryCatalog(filePath))
+        return binary->toCourses();
+    return parseCourseJsonStream(filePath);
+}
+
+QList<Course> JsonParser::parseCourseJsonStream(const QString& filePath, StringPool* pool) {
+    QList<Course> courses;
+    if (!parseCourseJsonStream(filePath, 0, [&courses](const QList<Course>& chunk) {
+            courses = chunk;
+            return true;
+        }, pool))
+        courses.clear();
+    return courses;
+}
+
+bool JsonParser::parseCourseJsonStream(const QString& filePath, int chunkSize,
+                                       const std::function<bool(const QList<Course>&)>& onChunk,
+                                       StringPool* pool) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "无法打开文件：" << filePath;
+        return false;
+    }
+
+    // 优先把文件映射进内存，由系统按页调入；无法映射（如 Qt 资源文件）时才整体读入
+    QByteArray buffer;
+    const char* data = nullptr;
+    qint64 length = file.size();
+    if (uchar* mapped = length > 0 ? file.map(0, length) : nullptr) {
+        data = reinterpret_cast<const char*>(mapped);
+    } else {
+        buffer = file.readAll();
+        data = buffer.constData();
+        length = buffer.size();
+    }
+
+    QList<Course> courses;
+    CourseSaxHandler handler(courses, [this](const QString& msg) { handleJsonError(msg); }, pool);
+    handler.setChunking(chunkSize, onChunk);
+    if (!nlohmann::json::sax_parse(data, data + length, &handler)) {
+        // 由 onChunk 中止时不算格式错误
+        if (!handler.wasStopped()) qWarning() << "课程文件格式错误：" << filePath;
+        return false;
+    }
+    return handler.flushChunk();
+}
+
+QList<Course> JsonParser::parseCourseJsonDom(const QString& filePath) {
     QList<Course> courses;
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
@@ -45,7 +382,43 @@ QList<Course> JsonParser::parseCourseJson(const QString& filePath) {
     return courses;
 }
 
-bool JsonParser::exportScheduleJson(const QList<ScheduledCourse>& schedule, const QString& filePath) {
+bool JsonParser::exportCourseJson(const QList<Course>& courses, const QString& filePath) {
+    QJsonArray arr;
+    for (const auto& c : courses) {
+        QJsonObject obj;
+        obj["id"] = c.id;
+        obj["name"] = c.name;
+        obj["credit"] = c.credit;
+        obj["required"] = c.required;
+        obj["prerequisites"] = QJsonArray::fromStringList(c.prerequisites);
+
+        QJsonArray offers;
+        for (const auto& off : c.offerings) {
+            QJsonObject o;
+            o["id"] = off.id;
+            o["teacher"] = off.teacher;
+            QJsonArray times;
+            for (int d = 0; d < 7; ++d)
+                times.append(static_cast<qint64>(off.times[d]));
+            o["times"] = times;
+            o["weeks"] = static_cast<qint64>(off.weeks);
+            offers.append(o);
+        }
+        obj["offerings"] = offers;
+        arr.append(obj);
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法写入文件：" << filePath;
+        return false;
+    }
+    file.write(QJsonDocument(arr).toJson(QJsonDocument::Indented));
+    file.close();
+    return true;
+}
+
+QJsonArray JsonParser::scheduleToJson(const QList<ScheduledCourse>& schedule) const {
     QJsonArray arr;
     for (const auto& sc : schedule) {
         QJsonObject obj;
@@ -54,8 +427,11 @@ bool JsonParser::exportScheduleJson(const QList<ScheduledCourse>& schedule, cons
         obj["semester"] = sc.semester;
         arr.append(obj);
     }
+    return arr;
+}
 
-    QJsonDocument doc(arr);
+bool JsonParser::exportScheduleJson(const QList<ScheduledCourse>& schedule, const QString& filePath) {
+    QJsonDocument doc(scheduleToJson(schedule));
     QFile file(filePath);
     if (!file.open(QIODevice::WriteOnly)) {
         qWarning() << "无法写入文件：" << filePath;
@@ -77,6 +453,8 @@ bool JsonParser::parseOfferings(const QJsonArray& arr, QVector<CourseOffering>&
         for (int i = 0; i < 7 && i < timesArr.size(); ++i) {
             off.times[i] = static_cast<quint32>(timesArr.at(i).toInt());
         }
+        if (obj.contains("weeks"))
+            off.weeks = static_cast<quint32>(obj["weeks"].toInteger());
         offerings.append(off);
     }
     return true;
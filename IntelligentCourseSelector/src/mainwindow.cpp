@@ -9,15 +9,18 @@
 #include <QFileDialog>
 #include <QStatusBar>
 #include <QLabel>
-#include <QTreeWidgetItem>
 #include <QTableWidgetItem>
 #include <QCoreApplication>
-#include <QBrush>
-#include <QColor>
+#include <QDebug>
+#include <QEvent>
+#include <QSignalBlocker>
+#include <algorithm>
+#include <iterator>
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
 {
+    startupTimer.start();
     mainTabs = new QTabWidget(this);
     setCentralWidget(mainTabs);
 
@@ -34,137 +37,243 @@ MainWindow::MainWindow(QWidget* parent)
     // 信号与槽连接
     connect(genButton, &QPushButton::clicked, this, &MainWindow::generateSchedule);
     connect(expButton, &QPushButton::clicked, this, &MainWindow::exportSchedule);
-    connect(courseTree, &QTreeWidget::itemClicked, this, &MainWindow::showCourseDetails);
+    connect(courseTree, &QTreeView::clicked, this, &MainWindow::showCourseDetails);
     connect(addButton, &QPushButton::clicked, this, &MainWindow::addSelectedCourse);
     connect(removeButton, &QPushButton::clicked, this, &MainWindow::removeSelectedCourse);
+    connect(prerequisiteButton, &QPushButton::clicked, this, &MainWindow::showPrerequisites);
     connect(preferenceButton, &QPushButton::clicked, this, &MainWindow::setCoursePreference);
     connect(conflictButton, &QPushButton::clicked, this, &MainWindow::showScheduleConflicts);
+    connect(searchEdit, &QLineEdit::textChanged, this, &MainWindow::filterCourses);
+    connect(freeTimeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::filterCourses);
+    connect(moreButton, &QPushButton::clicked, this, &MainWindow::nextAlternative);
+    connect(alternativeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::showAlternative);
+    connect(diversitySpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int) {
+        cancelScheduleJob();
+        resetAlternatives();
+    });
 }
 void MainWindow::addSelectedCourse() {
-    auto items = courseTree->selectedItems();
-    if (items.isEmpty()) {
+    const QModelIndex index = selectedCourse();
+    if (!index.isValid()) {
         showStatusMessage("请先选择一门课程", true);
         return;
     }
 
-    QString courseId = items[0]->data(0, Qt::UserRole).toString();
-    if (courseId.isEmpty()) {
-        showStatusMessage("无效的课程选择", true);
-        return;
-    }
+    QString courseId = index.data(CourseTreeModel::CourseIdRole).toString();
+    const QString name = index.data().toString();
 
     manuallySelected.insert(courseId);
-    showStatusMessage(QString("已添加课程：%1").arg(items[0]->text(0)));
-
-    // 更新 ScheduleManager 的选中课程 + 学分限制
-    schedMgr->setSelectedCourses(manuallySelected);
-    schedMgr->setTotalCreditLimit(creditSpinBox->value() * 2);
-    schedMgr->generateSchedule();
+    cancelScheduleJob();
+    resetAlternatives();
+
+    // 在现有课表上增量排入，已排课程保持不动
+    schedMgr->setCreditTarget(creditSpinBox->value() * 2);
+    if (schedMgr->insertCourse(courseId))
+        showStatusMessage(QString("已添加课程：%1").arg(name));
+    else
+        showStatusMessage(QString("已添加课程：%1，但当前课表中无法排入").arg(name), true);
     updateScheduleView();
 }
 
 void MainWindow::generateSchedule() {
-    showStatusMessage("正在生成课表...");
+    // 求解进行中时，该按钮用于取消
+    if (scheduleJob) {
+        cancelScheduleJob();
+        showStatusMessage("已取消生成课表");
+        return;
+    }
+
+    resetAlternatives();
 
-    // 从界面读取设置：选中课程集合和学分下限
+    // 从界面读取设置：选中课程集合、学分下限与上限
     schedMgr->setSelectedCourses(manuallySelected);
-    schedMgr->setTotalCreditLimit(creditSpinBox->value() * 2);
+    schedMgr->setCreditTarget(creditSpinBox->value() * 2);
+    schedMgr->setCreditCap(creditCapSpinBox->value() * 2);
+
+    // 在后台线程中对输入快照求解，界面保持响应
+    ScheduleJob* job = startScheduleJob(schedMgr->makeSnapshot(), schedMgr->cloneSolver());
+    connect(job, &ScheduleJob::progressChanged, this, [this, job](int percent) {
+        if (job != scheduleJob) return;
+        showStatusMessage(QString("正在生成课表... %1%").arg(percent));
+    });
+    connect(job, &ScheduleJob::bestChanged, this, [this, job](const ScheduleSolution& best) {
+        if (job != scheduleJob) return;
+        if (schedMgr->applySolution(best)) updateScheduleView();
+    });
+    connect(job, &ScheduleJob::finished, this, [this, job](const ScheduleSolution& solution, bool ok) {
+        if (job != scheduleJob) return;
+        scheduleJob = nullptr;
+        genButton->setText("生成选课方案");
+        moreButton->setEnabled(true);
+        if (!ok || !schedMgr->applySolution(solution)) {
+            showStatusMessage("排课失败，存在冲突或先修限制", true);
+            return;
+        }
+        updateScheduleView();
+        showStatusMessage("排课成功");
+    });
+    genButton->setText("取消生成");
+    moreButton->setEnabled(false);
+    showStatusMessage("正在生成课表...");
+    job->start();
+}
 
-    if (!schedMgr->generateSchedule()) {
-        showStatusMessage("排课失败，存在冲突或先修限制", true);
+// 备选方案：第一次点击时以当前课表为基准建立枚举器（候选课程相同，总学分不超过当前方案），
+// 之后每次只计算下一个方案，已算出的方案保留在下拉框中随时切换，不必重新求解
+void MainWindow::nextAlternative() {
+    if (scheduleJob) return;
+    // 枚举器同一时刻只能在一个线程中使用：上一次被取消的计算退出之前不能开始下一次
+    if (enumeratorJob) {
+        showStatusMessage("正在停止上一次计算，请稍后再试", true);
         return;
     }
+    if (!enumerator) {
+        alternativeSnapshot = schedMgr->makeAlternativeSnapshot();
+        if (!alternativeSnapshot) {
+            showStatusMessage("请先生成选课方案", true);
+            return;
+        }
+        enumerator = std::make_shared<ScheduleEnumerator>(alternativeSnapshot->problem,
+                                                          diversitySpinBox->value());
+    }
+
+    ScheduleJob* job = startScheduleJob(alternativeSnapshot,
+                                        std::unique_ptr<ScheduleSolver>(new NextScheduleSolver(enumerator)));
+    enumeratorJob = job;
+    connect(job, &ScheduleJob::progressChanged, this, [this, job](int percent) {
+        if (job != scheduleJob) return;
+        showStatusMessage(QString("正在计算下一个方案... %1%").arg(percent));
+    });
+    connect(job, &ScheduleJob::finished, this, [this, job](const ScheduleSolution& solution, bool ok) {
+        if (job != scheduleJob) return;
+        scheduleJob = nullptr;
+        enumeratorJob = nullptr;   // 发出 finished 时求解线程已离开枚举器
+        genButton->setText("生成选课方案");
+        moreButton->setEnabled(true);
+        if (!ok) {
+            showStatusMessage("没有更多满足差异要求的方案", true);
+            return;
+        }
+        alternatives.append(solution);
+        const int count = alternatives.size();
+        alternativeCombo->addItem(QString("方案 %1（得分 %2，%3 学分）")
+                                  .arg(count).arg(solution.score).arg(solution.credits));
+        alternativeCombo->setCurrentIndex(count - 1);
+    });
+    genButton->setText("取消生成");
+    moreButton->setEnabled(false);
+    showStatusMessage("正在计算下一个方案...");
+    job->start();
+}
+
+// 创建后台排课任务。任务在 finished / canceled 之后自行释放，界面不必等待求解线程。
+// 界面上的连接以窗口为上下文，被取消的任务由 cancelScheduleJob 断开；断开之前已排队的信号
+// 仍会送达，各回调因此先确认任务仍是当前任务。任务的释放排在它发出的全部信号之后，
+// 比较指针不会误认
+ScheduleJob* MainWindow::startScheduleJob(std::shared_ptr<const ScheduleSnapshot> snapshot,
+                                          std::unique_ptr<ScheduleSolver> solver) {
+    ScheduleJob* job = new ScheduleJob(std::move(snapshot), std::move(solver), this);
+    connect(job, &ScheduleJob::finished, job, &QObject::deleteLater);
+    connect(job, &ScheduleJob::canceled, job, &QObject::deleteLater);
+    scheduleJob = job;
+    return job;
+}
+
+void MainWindow::showAlternative(int index) {
+    if (index < 0 || index >= alternatives.size()) return;
+    if (!schedMgr->applySolution(alternatives[index])) return;
     updateScheduleView();
-    showStatusMessage("排课成功");
+    if (index == 0) {
+        showStatusMessage("已切换到方案 1");
+    } else {
+        showStatusMessage(QString("已切换到方案 %1，与方案 1 有 %2 门课程安排不同").arg(index + 1)
+                          .arg(ScheduleEnumerator::distance(alternatives[0].placements, alternatives[index].placements)));
+    }
+}
+
+void MainWindow::resetAlternatives() {
+    enumerator.reset();
+    enumeratorJob = nullptr;   // 仍在退出的任务持有旧枚举器，不妨碍新建的枚举器
+    alternativeSnapshot.reset();
+    alternatives.clear();
+    QSignalBlocker blocker(alternativeCombo);
+    alternativeCombo->clear();
+}
+
+// 用户取消或修改了排课输入时调用；已显示的阶段性方案保留在课表中。
+// 不等待求解线程：cancel() 先交出暂存的最优解，随后断开界面连接，
+// 已排队的进度与结果不再写回；线程在下一个检查点退出后任务自行释放
+void MainWindow::cancelScheduleJob() {
+    if (!scheduleJob) return;
+    ScheduleJob* job = scheduleJob;
+    job->cancel();   // 暂存的最优解在此同步送达，须在清空 scheduleJob 之前
+    scheduleJob = nullptr;
+    disconnect(job, nullptr, this, nullptr);
+    genButton->setText("生成选课方案");
+    moreButton->setEnabled(true);
 }
 
 void MainWindow::updateScheduleView() {
+    // 视图按下标直接绘制；内容未变的学期 setContents 直接返回，不触发重绘
     for (int sem = 0; sem < 8; ++sem) {
-        auto page = semesterTabs->widget(sem);
-        auto tbl = page->findChild<QTableWidget*>();
-        tbl->clearContents();
-        auto list = schedMgr->getCoursesForSemester(sem);
-        for (auto& sc : list) {
-            const Course* pc = nullptr;
-            for (auto& c : courses) {
-                if (c.id == sc.courseId) {
-                    pc = &c;
-                    break;
-                }
-            }
-            if (!pc) continue;
-            const auto& off = pc->getOffering(sc.classId);
-            for (int d = 0; d < 7; ++d) {
-                if (off.times[d] == 0) continue;
-                for (int s = 0; s < 13; ++s) {
-                    if (off.times[d] & (1u << s)) {
-                        QTableWidgetItem* item = new QTableWidgetItem(pc->name);
-                        item->setBackground(pc->required == "Compulsory" ?
-                                                QBrush(QColor(173, 216, 230)) : QBrush(QColor(255, 255, 224)));
-                        QString tooltip = QString("%1\n教师:%2\n学分:%3\n时间:%4")
-                                              .arg(pc->name).arg(off.teacher).arg(pc->credit).arg(off.timeSlotsToString());
-                        item->setToolTip(tooltip);
-                        tbl->setItem(s, d, item);
-                    }
-                }
-            }
-        }
+        SlotMask blocked;
+        for (int d = 0; d < 7; ++d)
+            blocked.day[d] = static_cast<quint16>(schedMgr->getBlockedTime(sem, d));
+        timetables[sem]->setContents(schedMgr->getPlacementsForSemester(sem), blocked);
         int creditSum = schedMgr->getCreditSum(sem);
         semesterTabs->setTabText(sem, QString("学期%1 (%2 学分)").arg(sem + 1).arg(creditSum));
     }
+    // 空闲时间随课表变化，按空闲时间过滤时同步刷新课程树
+    if (freeTimeCombo->currentIndex() > 0) applyCourseFilter();
 }
 
 void MainWindow::setCreditLimits(int) {
-    schedMgr->setTotalCreditLimit(creditSpinBox->value() * 2);
+    cancelScheduleJob();
+    resetAlternatives();
+    schedMgr->setCreditTarget(creditSpinBox->value() * 2);
+    schedMgr->setCreditCap(creditCapSpinBox->value() * 2);
 }
 
 void MainWindow::removeSelectedCourse() {
-    auto items = courseTree->selectedItems();
-    if (items.isEmpty()) return;
-    QString courseId = items[0]->data(0, Qt::UserRole).toString();
+    const QModelIndex index = selectedCourse();
+    if (!index.isValid()) return;
+    QString courseId = index.data(CourseTreeModel::CourseIdRole).toString();
     manuallySelected.remove(courseId);
-    schedMgr->setSelectedCourses(manuallySelected);
-    schedMgr->generateSchedule();
+    cancelScheduleJob();
+    resetAlternatives();
+    schedMgr->retractCourse(courseId);
     updateScheduleView();
 }
 
-void MainWindow::showCourseDetails(QTreeWidgetItem* it, int) {
+void MainWindow::showCourseDetails(const QModelIndex& index) {
     courseDetail->setRowCount(0);
-    QString cid = it->data(0, Qt::UserRole).toString();
-    const Course* pc = nullptr;
-    for (auto& c : courses) {
-        if (c.id == cid) { pc = &c; break; }
+    auto rows = courseModel->details(index);
+    if (rows.isEmpty()) return;
+    // 优先级属于排课状态而非课程本身，插在“类型”之后；加载期间排课器尚未建好，不显示
+    if (schedMgr) {
+        const QString cid = index.data(CourseTreeModel::CourseIdRole).toString();
+        rows.insert(4, {"优先级", QString::number(schedMgr->getPriority(cid))});
     }
-    if (!pc) return;
-
-    int row = 0;
-    auto add = [&](const QString& k, const QString& v) {
-        courseDetail->insertRow(row);
-        courseDetail->setItem(row, 0, new QTableWidgetItem(k));
-        courseDetail->setItem(row, 1, new QTableWidgetItem(v));
-        ++row;
-    };
-    add("ID", pc->id);
-    add("名称", pc->name);
-    add("学分", QString::number(pc->credit));
-    add("类型", pc->required == "Compulsory" ? "必修" : "选修");
-    add("优先级", QString::number(schedMgr->getPriority(pc->id)));
-    add("先修课程", pc->prerequisites.join("，"));
-    for (auto& o : pc->offerings) {
-        add("班次", o.id);
-        add("教师", o.teacher);
-        add("时间", o.timeSlotsToString());
+
+    courseDetail->setRowCount(rows.size());
+    for (int row = 0; row < rows.size(); ++row) {
+        courseDetail->setItem(row, 0, new QTableWidgetItem(rows[row].first));
+        courseDetail->setItem(row, 1, new QTableWidgetItem(rows[row].second));
     }
 }
 
 void MainWindow::setCoursePreference() {
-    auto items = courseTree->selectedItems();
-    if (items.isEmpty()) return;
-    QString courseId = items[0]->data(0, Qt::UserRole).toString();
+    const QModelIndex index = selectedCourse();
+    if (!index.isValid()) return;
+    QString courseId = index.data(CourseTreeModel::CourseIdRole).toString();
     bool ok;
     int priority = QInputDialog::getInt(this, "设置优先级",
                                         "请输入课程优先级(1-10)：", 5, 1, 10, 1, &ok);
     if (ok) {
+        cancelScheduleJob();
+        resetAlternatives();
         schedMgr->setPriority(courseId, priority);
         showStatusMessage(QString("已设置课程 %1 的优先级为 %2").arg(courseId).arg(priority));
     }
@@ -183,7 +292,10 @@ void MainWindow::setBlockedTime() {
         showStatusMessage("请至少选择一个时间段", true);
         return;
     }
+    cancelScheduleJob();
+    resetAlternatives();
     schedMgr->addBlockedTime(semester, day, mask);
+    updateScheduleView();
     showStatusMessage(QString("已设置第%1学期 %2 的屏蔽时间").arg(semester + 1).arg(dayCombo->currentText()));
 }
 
@@ -203,15 +315,32 @@ void MainWindow::showScheduleConflicts() {
 }
 
 void MainWindow::showPrerequisites() {
-    auto items = courseTree->selectedItems();
-    if (items.isEmpty()) return;
-    QString cid = items[0]->data(0, Qt::UserRole).toString();
+    const QModelIndex index = selectedCourse();
+    if (!index.isValid()) {
+        showStatusMessage("请先选择一门课程", true);
+        return;
+    }
+    QString cid = index.data(CourseTreeModel::CourseIdRole).toString();
     auto pre = schedMgr->getPrerequisites(cid);
+    // 完整先修链与后续课程都直接取自先修闭包
+    const QList<QString> chain = schedMgr->getPrerequisiteChain(cid);
+    const QList<QString> dependents = schedMgr->getDependentCourses(cid);
+    const int earliest = schedMgr->getEarliestSemester(cid);
+    QString text;
     if (pre.isEmpty()) {
-        QMessageBox::information(this, "无先修课程", "该课程无先修要求");
+        text = "该课程无先修要求";
     } else {
-        QMessageBox::information(this, "先修课程", pre.join("\n"));
+        text = "直接先修：\n" + pre.join("\n");
+        if (chain.size() > pre.size())
+            text += QString("\n\n完整先修链（共 %1 门，按修读先后）：\n").arg(chain.size()) + chain.join("、");
     }
+    if (earliest < 0)
+        text += "\n\n先修关系成环，无法排课";
+    else if (earliest > 0)
+        text += QString("\n\n最早可在第 %1 学期修读").arg(earliest + 1);
+    if (!dependents.isEmpty())
+        text += QString("\n\n以本课程为（间接）先修的课程共 %1 门").arg(dependents.size());
+    QMessageBox::information(this, pre.isEmpty() ? "无先修课程" : "先修课程", text);
 }
 
 void MainWindow::exportSchedule() {
@@ -234,18 +363,72 @@ void MainWindow::exportSchedule() {
     }
 }
 
+void MainWindow::filterCourses() {
+    const int count = applyCourseFilter();
+    if (count >= 0) showStatusMessage(QString("找到 %1 门课程").arg(count));
+}
+
+// 每次按键只查一次倒排索引，空闲时间由节次倒排位图求出，两者都是升序下标，
+// 取交集后课程树按结果重置（视图只布局可见的行）
+int MainWindow::applyCourseFilter() {
+    const QString text = searchEdit->text();
+    const int sem = freeTimeCombo->currentIndex() - 1;
+    int count = -1;
+    if (text.trimmed().isEmpty() && sem < 0) {
+        courseModel->clearFilter();
+    } else {
+        QVector<int> matches;
+        if (sem >= 0) matches = schedMgr->getFittingCourses(sem);
+        if (!text.trimmed().isEmpty()) {
+            const QVector<int> hits = searchIndex.search(text);
+            if (sem < 0) {
+                matches = hits;
+            } else {
+                QVector<int> both;
+                std::set_intersection(matches.cbegin(), matches.cend(), hits.cbegin(), hits.cend(),
+                                      std::back_inserter(both));
+                matches = both;
+            }
+        }
+        courseModel->setFilter(matches);
+        count = matches.size();
+    }
+    expandCourseGroups();
+    return count;
+}
+
 void MainWindow::showStatusMessage(const QString& message, bool isError) {
     statusLabel->setText(message);
     statusLabel->setStyleSheet(isError ? "color: red;" : "color: black;");
 }
+
+QModelIndex MainWindow::selectedCourse() const {
+    const QModelIndex index = courseTree->currentIndex();
+    return courseModel && courseModel->courseAt(index) >= 0 ? index : QModelIndex();
+}
 void MainWindow::setupCourseTab() {
     QWidget* tab = new QWidget;
     QVBoxLayout* mainLayout = new QVBoxLayout(tab);
 
+    searchEdit = new QLineEdit(tab);
+    searchEdit->setPlaceholderText("搜索课程名称、课程ID或教师（空格分隔多个关键词）");
+    searchEdit->setClearButtonEnabled(true);
+    searchEdit->setEnabled(false);   // 检索索引随目录一起构建，加载完成后启用
+    freeTimeCombo = new QComboBox(tab);
+    freeTimeCombo->addItem("全部课程");
+    for (int i = 1; i <= 8; ++i)
+        freeTimeCombo->addItem(QString("第%1学期空闲时间可排").arg(i));
+    freeTimeCombo->setEnabled(false);
+    QHBoxLayout* filterLayout = new QHBoxLayout;
+    filterLayout->addWidget(searchEdit, 1);
+    filterLayout->addWidget(freeTimeCombo);
+    mainLayout->addLayout(filterLayout);
+
     QSplitter* spl = new QSplitter(Qt::Horizontal, tab);
-    courseTree = new QTreeWidget(spl);
-    courseTree->setHeaderLabel("课程分类");
+    courseTree = new QTreeView(spl);
     courseTree->setMinimumWidth(200);
+    // 行高一致时视图无需逐行测量，十万级课程也只布局可见的行
+    courseTree->setUniformRowHeights(true);
 
     courseDetail = new QTableWidget(spl);
     courseDetail->setColumnCount(2);
@@ -257,9 +440,11 @@ void MainWindow::setupCourseTab() {
     QHBoxLayout* btnLayout = new QHBoxLayout;
     addButton = new QPushButton("添加到选课方案", tab);
     removeButton = new QPushButton("移除课程", tab);
+    prerequisiteButton = new QPushButton("先修课程", tab);
     preferenceButton = new QPushButton("设置优先级", tab);
     btnLayout->addWidget(addButton);
     btnLayout->addWidget(removeButton);
+    btnLayout->addWidget(prerequisiteButton);
     btnLayout->addWidget(preferenceButton);
     mainLayout->addLayout(btnLayout);
 
@@ -281,8 +466,20 @@ void MainWindow::setupScheduleTab() {
     connect(creditSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
             this, &MainWindow::setCreditLimits);
 
+    // 精确求解、局部搜索与备选方案遵守的总学分上限，贪心不看它
+    QLabel* capLabel = new QLabel("总学分上限（×2，0 为不限）:", tab);
+    creditCapSpinBox = new QSpinBox(tab);
+    creditCapSpinBox->setRange(0, 500);
+    creditCapSpinBox->setValue(0);
+    creditCapSpinBox->setSuffix(" 分");
+
+    connect(creditCapSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::setCreditLimits);
+
     topLayout->addWidget(creditLabel);
     topLayout->addWidget(creditSpinBox);
+    topLayout->addWidget(capLabel);
+    topLayout->addWidget(creditCapSpinBox);
     topLayout->addStretch();
     vlay->addLayout(topLayout);
 
@@ -291,18 +488,10 @@ void MainWindow::setupScheduleTab() {
         QWidget* page = new QWidget;
         QVBoxLayout* layout = new QVBoxLayout(page);
         QLabel* title = new QLabel(QString("第%1学期").arg(sem + 1), page);
-        QTableWidget* tbl = new QTableWidget(13, 7, page);
-        tbl->setHorizontalHeaderLabels({"周一","周二","周三","周四","周五","周六","周日"});
-        QStringList vhead;
-        for (int i = 0; i < 13; ++i) {
-            int m = 8 * 60 + i * 45;
-            vhead << QString("%1:%2").arg(m / 60).arg(m % 60, 2, 10, QChar('0'));
-        }
-        tbl->setVerticalHeaderLabels(vhead);
-        tbl->setEditTriggers(QAbstractItemView::NoEditTriggers);
-        tbl->setSelectionMode(QAbstractItemView::SingleSelection);
+        TimetableView* view = new TimetableView(page);
+        timetables.append(view);
         layout->addWidget(title);
-        layout->addWidget(tbl);
+        layout->addWidget(view);
         page->setLayout(layout);
         semesterTabs->addTab(page, QString("学期%1").arg(sem + 1));
     }
@@ -317,12 +506,29 @@ void MainWindow::setupScheduleTab() {
     btns->addWidget(conflictButton);
     vlay->addLayout(btns);
 
+    // 备选方案：按得分从高到低逐个计算，方案之间至少相差若干门课程
+    QHBoxLayout* altRow = new QHBoxLayout;
+    QLabel* diversityLabel = new QLabel("方案间至少相差:", tab);
+    diversitySpinBox = new QSpinBox(tab);
+    diversitySpinBox->setRange(1, 50);
+    diversitySpinBox->setValue(2);
+    diversitySpinBox->setSuffix(" 门课程");
+    moreButton = new QPushButton("计算下一个方案", tab);
+    alternativeCombo = new QComboBox(tab);
+    alternativeCombo->setMinimumContentsLength(20);
+    altRow->addWidget(diversityLabel);
+    altRow->addWidget(diversitySpinBox);
+    altRow->addWidget(moreButton);
+    altRow->addWidget(alternativeCombo, 1);
+    vlay->addLayout(altRow);
+
     tab->setLayout(vlay);
     mainTabs->addTab(tab, "课表展示");
 }
 
 void MainWindow::setupPreferenceTab() {
     QWidget* tab = new QWidget;
+    preferenceTab = tab;
     QVBoxLayout* layout = new QVBoxLayout(tab);
 
     QGroupBox* group = new QGroupBox("时间限制设置", tab);
@@ -372,25 +578,70 @@ void MainWindow::setupPreferenceTab() {
     mainTabs->addTab(tab, "偏好设置");
 }
 
+// 窗口先显示，课程在后台线程解析并逐批出现在课程树中；
+// 目录与先修图建好之前，依赖排课器的操作保持禁用
 void MainWindow::loadCourses() {
     QString path = QCoreApplication::applicationDirPath() + "/data/course.json";
-    courses = parser.parseCourseJson(path);
-    schedMgr = new ScheduleManager(courses);
-
-    QTreeWidgetItem* comp = new QTreeWidgetItem(courseTree);
-    comp->setText(0, "必修课程");
-    QTreeWidgetItem* elec = new QTreeWidgetItem(courseTree);
-    elec->setText(0, "选修课程");
-
-    for (auto& c : courses) {
-        QTreeWidgetItem* item = new QTreeWidgetItem();
-        item->setText(0, c.name);
-        item->setData(0, Qt::UserRole, c.id);
-        item->setToolTip(0, QString("学分：%1\n类型：%2").arg(c.credit).arg(c.required));
-        if (c.required == "Compulsory")
-            comp->addChild(item);
-        else
-            elec->addChild(item);
+    setSchedulingEnabled(false);
+    showStatusMessage("正在加载课程...");
+
+    courseModel = new CourseTreeModel(nullptr, this);
+    courseTree->setModel(courseModel);
+
+    catalogLoader = new CatalogLoader(path, this);
+    connect(catalogLoader, &CatalogLoader::coursesLoaded, this, [this](const QList<Course>& chunk) {
+        courseModel->appendCourses(chunk);
+        expandCourseGroups();
+        const int loaded = courseModel->rowCount(courseModel->index(0, 0)) +
+                           courseModel->rowCount(courseModel->index(1, 0));
+        showStatusMessage(QString("正在加载课程... 已载入 %1 门").arg(loaded));
+    });
+    connect(catalogLoader, &CatalogLoader::finished, this, &MainWindow::finishLoading);
+    catalogLoader->start();
+}
+
+void MainWindow::finishLoading(bool ok) {
+    schedMgr = catalogLoader->takeManager().release();
+    searchIndex = catalogLoader->takeSearchIndex();
+    catalogLoader->deleteLater();
+    catalogLoader = nullptr;
+
+    // 课程树与课表直接读排课器的目录，不再为每门课程创建条目
+    courseModel->setCatalog(&schedMgr->getCatalog());
+    for (TimetableView* view : timetables)
+        view->setCatalog(&schedMgr->getCatalog());
+    expandCourseGroups();
+    setSchedulingEnabled(true);
+    searchEdit->setEnabled(true);
+    freeTimeCombo->setEnabled(true);
+
+    const int count = schedMgr->getCatalog().courseCount();
+    qInfo().noquote() << QString("启动：可交互 %1 ms（%2 门课程）").arg(startupTimer.elapsed()).arg(count);
+    if (ok)
+        showStatusMessage(QString("已加载 %1 门课程").arg(count));
+    else
+        showStatusMessage("课程文件加载失败", true);
+}
+
+void MainWindow::setSchedulingEnabled(bool enabled) {
+    const QList<QWidget*> widgets = {addButton, removeButton, prerequisiteButton, preferenceButton,
+                                     genButton, expButton, conflictButton, creditSpinBox, creditCapSpinBox,
+                                     preferenceTab, diversitySpinBox, moreButton, alternativeCombo};
+    for (QWidget* w : widgets)
+        w->setEnabled(enabled);
+}
+
+void MainWindow::expandCourseGroups() {
+    for (int g = 0; g < courseModel->rowCount(); ++g)
+        courseTree->expand(courseModel->index(g, 0));
+}
+
+// 第一次绘制主窗口时记录首帧耗时
+bool MainWindow::event(QEvent* e) {
+    const bool handled = QMainWindow::event(e);
+    if (e->type() == QEvent::Paint && !firstFrameLogged) {
+        firstFrameLogged = true;
+        qInfo().noquote() << QString("启动：首帧 %1 ms").arg(startupTimer.elapsed());
     }
-    courseTree->expandAll();
+    return handled;
 }
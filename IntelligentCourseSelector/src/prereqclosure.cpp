@@ -0,0 +1,97 @@
+#include "prereqclosure.h"
+#include <QDebug>
+#include <QtGlobal>
+#include <algorithm>
+
+PrereqClosure::PrereqClosure(const PrereqGraph& graph) {
+    const int n = graph.nodeCount();
+    depths.fill(-1, n);
+
+    // 只按已知的先修边做 Kahn 排序（不计未知先修），order 本身充当队列
+    QVector<int> indeg(n);
+    QVector<int> order;
+    order.reserve(n);
+    for (int c = 0; c < n; ++c) {
+        indeg[c] = graph.prerequisites(c).size();
+        if (indeg[c] == 0) order.append(c);
+    }
+    for (int head = 0; head < order.size(); ++head) {
+        for (int d : graph.dependents(order[head])) {
+            if (--indeg[d] == 0) order.append(d);
+        }
+    }
+
+    // 沿拓扑序合并：anc(c) = ∪ {p} ∪ anc(p)，p 取 c 的直接先修课。
+    // 先按拓扑序追加到 flat，mark 记录本轮已加入的课程以免重复
+    QVector<int>& flat = ancestorList;
+    QVector<int>& first = ancestorFirst;
+    QVector<int>& count = ancestorCount;
+    first.fill(0, n);
+    count.fill(0, n);
+    QVector<int> mark(n, -1);
+    for (int c : order) {
+        int d = 0;
+        const int begin = flat.size();
+        for (int p : graph.prerequisites(c)) {
+            d = qMax(d, depths[p] + 1);
+            if (!complete) continue;
+            if (mark[p] != c) { mark[p] = c; flat.append(p); }
+            for (int i = first[p]; i < first[p] + count[p]; ++i) {
+                const int a = flat[i];
+                if (mark[a] != c) { mark[a] = c; flat.append(a); }
+            }
+        }
+        depths[c] = d;
+        if (!complete) continue;
+        if (flat.size() > MaxPairs) {
+            qWarning() << "PrereqClosure: 先修闭包超过" << MaxPairs << "对，只保留链深度";
+            complete = false;
+            flat = QVector<int>();
+            first = QVector<int>();
+            count = QVector<int>();
+            continue;
+        }
+        std::sort(flat.begin() + begin, flat.end());
+        first[c] = begin;
+        count[c] = flat.size() - begin;
+    }
+    if (!complete) return;
+
+    // 先修表就地留在 flat 中，只去掉倍增扩容留下的余量，不再按课程下标另拷一份。
+    // 后续课程表即闭包的转置，按课程下标顺序填充后天然有序
+    flat.squeeze();
+    descendantStart.fill(0, n + 1);
+    for (int c = 0; c < n; ++c) {
+        for (int i = first[c]; i < first[c] + count[c]; ++i)
+            ++descendantStart[flat[i] + 1];
+    }
+    for (int c = 0; c < n; ++c)
+        descendantStart[c + 1] += descendantStart[c];
+    descendantList.resize(flat.size());
+    QVector<int> fill = descendantStart;
+    for (int c = 0; c < n; ++c) {
+        for (int i = first[c]; i < first[c] + count[c]; ++i)
+            descendantList[fill[flat[i]]++] = c;
+    }
+}
+
+bool PrereqClosure::dependsOn(const PrereqGraph& graph, int course, int pre) const {
+    if (complete) {
+        const Range r = ancestors(course);
+        return std::binary_search(r.begin(), r.end(), pre);
+    }
+    // 先修课的链深度一定更小，深度都已知时可直接排除
+    if (depths[course] >= 0 && depths[pre] >= 0 && depths[pre] >= depths[course])
+        return false;
+    QVector<bool> seen(graph.nodeCount(), false);
+    QVector<int> stack{course};
+    while (!stack.isEmpty()) {
+        for (int p : graph.prerequisites(stack.takeLast())) {
+            if (p == pre) return true;
+            if (seen[p]) continue;
+            seen[p] = true;
+            stack.append(p);
+        }
+    }
+    return false;
+}
@@ -0,0 +1,126 @@
+#include "prereqgraph.h"
+#include <QPair>
+#include <QtGlobal>
+#include <algorithm>
+
+PrereqGraph::PrereqGraph(const CourseCatalog& catalog) {
+    const int n = catalog.courseCount();
+    forwardStart.fill(0, n + 1);
+    reverseStart.fill(0, n + 1);
+    blocked.fill(false, n);
+
+    // 第一遍统计出入度，第二遍按前缀和填充
+    for (int c = 0; c < n; ++c) {
+        blocked[c] = catalog.hasUnresolvedPrerequisite(c);
+        for (int p : catalog.prerequisites(c)) {
+            ++forwardStart[p + 1];
+            ++reverseStart[c + 1];
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        forwardStart[i + 1] += forwardStart[i];
+        reverseStart[i + 1] += reverseStart[i];
+    }
+    forwardTargets.resize(forwardStart[n]);
+    reverseTargets.resize(reverseStart[n]);
+
+    QVector<int> fill = forwardStart;
+    for (int c = 0; c < n; ++c) {
+        int r = reverseStart[c];
+        for (int p : catalog.prerequisites(c)) {
+            forwardTargets[fill[p]++] = c;
+            reverseTargets[r++] = p;
+        }
+    }
+}
+
+bool PrereqGraph::sort(QVector<int>& order, QList<QVector<int>>* cycles) const {
+    const int n = nodeCount();
+    QVector<int> indeg(n);
+    order.clear();
+    order.reserve(n);
+    for (int c = 0; c < n; ++c) {
+        indeg[c] = prerequisites(c).size() + (blocked[c] ? 1 : 0);
+        if (indeg[c] == 0) order.append(c);
+    }
+
+    // order 本身充当队列
+    for (int head = 0; head < order.size(); ++head) {
+        for (int d : dependents(order[head])) {
+            if (--indeg[d] == 0) order.append(d);
+        }
+    }
+
+    if (order.size() == n) {
+        if (cycles) cycles->clear();
+        return true;
+    }
+    if (cycles) {
+        QVector<bool> remaining(n, false);
+        for (int c = 0; c < n; ++c)
+            remaining[c] = indeg[c] > 0;
+        *cycles = findCycles(remaining);
+    }
+    return false;
+}
+
+QList<QVector<int>> PrereqGraph::findCycles(const QVector<bool>& remaining) const {
+    // 在未排出的节点上做迭代版 Tarjan，只保留真正成环的强连通分量
+    const int n = nodeCount();
+    QVector<int> index(n, -1), low(n, 0);
+    QVector<bool> onStack(n, false);
+    QVector<int> stack;
+    QVector<QPair<int, int>> callStack;   // (节点, 已访问的出边数)
+    QList<QVector<int>> result;
+    int counter = 0;
+
+    for (int root = 0; root < n; ++root) {
+        if (!remaining[root] || index[root] >= 0) continue;
+        callStack.append(qMakePair(root, 0));
+        index[root] = low[root] = counter++;
+        stack.append(root);
+        onStack[root] = true;
+
+        while (!callStack.isEmpty()) {
+            int v = callStack.last().first;
+            Range out = dependents(v);
+            int& next = callStack.last().second;
+            if (next < out.size()) {
+                int w = out.begin()[next++];
+                if (!remaining[w]) continue;
+                if (index[w] < 0) {
+                    index[w] = low[w] = counter++;
+                    stack.append(w);
+                    onStack[w] = true;
+                    callStack.append(qMakePair(w, 0));
+                } else if (onStack[w]) {
+                    low[v] = qMin(low[v], index[w]);
+                }
+                continue;
+            }
+
+            callStack.removeLast();
+            if (!callStack.isEmpty()) {
+                int parent = callStack.last().first;
+                low[parent] = qMin(low[parent], low[v]);
+            }
+            if (low[v] != index[v]) continue;
+
+            QVector<int> component;
+            int w;
+            do {
+                w = stack.takeLast();
+                onStack[w] = false;
+                component.append(w);
+            } while (w != v);
+
+            bool selfLoop = component.size() == 1
+                            && std::find(out.begin(), out.end(), v) != out.end();
+            if (component.size() > 1 || selfLoop) {
+                std::sort(component.begin(), component.end());
+                result.append(component);
+            }
+        }
+    }
+    return result;
+}
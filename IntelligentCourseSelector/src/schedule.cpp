@@ -1,155 +1,353 @@
 #include "schedule.h"
 #include <QDebug>
-#include <QQueue>
 #include <QtGlobal>
+#include <algorithm>
 
 ScheduleManager::ScheduleManager(const QList<Course>& courses)
-    : allCourses(courses),
-    creditLimits(8, 500),  // 默认每学期上限 500
-    blockedTime(8, QVector<quint32>(7, 0)),
-    totalCreditLimit(0)    // 默认总学分限制为 0
+    : ScheduleManager(CourseCatalog(courses))
 {
-    for (const auto& course : allCourses) {
-        priorities[course.id] = 5;
+}
+
+ScheduleManager::ScheduleManager(CourseCatalog catalog)
+    : creditLimits(8, 500),  // 默认每学期上限 500
+    blockedTime(8),
+    occupancy(8),
+    semCredits(8, 0),
+    creditTarget(0),   // 默认总学分目标为 0
+    creditCap(0),      // 默认总学分不设上限
+    solver(new GreedySolver)
+{
+    setCatalog(std::move(catalog));
+}
+
+void ScheduleManager::setCourses(const QList<Course>& courses) {
+    setCatalog(CourseCatalog(courses));
+}
+
+void ScheduleManager::setCatalog(CourseCatalog newCatalog) {
+    catalog = std::move(newCatalog);
+    const int n = catalog.courseCount();
+    clearSchedule();
+    placedSemester.fill(-1, n);
+    priorities.fill(5, n);
+    selectedCourses = QBitArray(n);
+    slotIndex = SlotIndex(catalog);
+    rebuildGraph();
+}
+
+void ScheduleManager::rebuildGraph() {
+    graph = PrereqGraph(catalog);
+    closure = PrereqClosure(graph);
+    if (!graph.sort(topoOrder, &cycles)) {
+        // 排序失败可能源于环，也可能只是引用了未知先修课程，两者分开报告
+        if (!cycles.isEmpty()) {
+            QStringList desc;
+            for (const auto& cyc : cycles) {
+                QStringList ids;
+                for (int c : cyc) ids.append(catalog.courseId(c));
+                desc.append("[" + ids.join(", ") + "]");
+            }
+            qWarning() << "检测到循环先修课程依赖！" << desc.join(" ");
+        }
+        QStringList unresolvedIds;
+        for (int c = 0; c < catalog.courseCount(); ++c) {
+            if (catalog.hasUnresolvedPrerequisite(c))
+                unresolvedIds.append(catalog.courseId(c));
+        }
+        if (!unresolvedIds.isEmpty())
+            qWarning() << "以下课程引用了未知先修课程，无法排课：" << unresolvedIds.join(", ");
     }
+    topoRank.fill(-1, catalog.courseCount());
+    for (int i = 0; i < topoOrder.size(); ++i)
+        topoRank[topoOrder[i]] = i;
+    greedyOrderDirty = true;
 }
 
 int ScheduleManager::getPriority(const QString& courseId) const {
-    return priorities.value(courseId, 0);
+    int c = catalog.courseIndex(courseId);
+    return c < 0 ? 0 : priorities[c];
+}
+
+void ScheduleManager::setCreditTarget(int credit) {
+    creditTarget = credit;
 }
 
-void ScheduleManager::setTotalCreditLimit(int credit) {
-    totalCreditLimit = credit;
+void ScheduleManager::setCreditCap(int credit) {
+    creditCap = credit;
 }
 
 void ScheduleManager::setSelectedCourses(const QSet<QString>& courseIds) {
-    selectedCourses = courseIds;
+    selectedCourses.fill(false);
+    for (const auto& id : courseIds) {
+        int c = catalog.courseIndex(id);
+        if (c >= 0) selectedCourses.setBit(c);
+    }
 }
 
 QList<QString> ScheduleManager::topologicalSort() const {
-    QMap<QString,int> indeg;
-    for (auto& c : allCourses)
-        indeg[c.id] = c.prerequisites.size();
-    QQueue<QString> q;
-    for (auto it = indeg.cbegin(); it != indeg.cend(); ++it) {
-        if (it.value() == 0) q.enqueue(it.key());
-    }
     QList<QString> result;
-    while (!q.isEmpty()) {
-        auto cur = q.dequeue();
-        result.append(cur);
-        for (auto& c : allCourses) {
-            if (c.prerequisites.contains(cur)) {
-                indeg[c.id]--;
-                if (indeg[c.id] == 0) q.enqueue(c.id);
-            }
-        }
-    }
-    if (result.size() != allCourses.size()) {
-        qWarning() << "检测到循环先修课程依赖！";
+    result.reserve(topoOrder.size());
+    for (int c : topoOrder)
+        result.append(catalog.courseId(c));
+    return result;
+}
+
+QList<QStringList> ScheduleManager::prerequisiteCycles() const {
+    QList<QStringList> result;
+    for (const auto& cyc : cycles) {
+        QStringList ids;
+        for (int c : cyc) ids.append(catalog.courseId(c));
+        result.append(ids);
     }
     return result;
 }
 
-bool ScheduleManager::generateSchedule() {
-    schedule.clear();
-    QVector<int> semCredit(8, 0);
-    int totalCredit = 0;
+void ScheduleManager::setSolver(std::unique_ptr<ScheduleSolver> s) {
+    if (s) solver = std::move(s);
+}
 
-    auto order = topologicalSort();
-    std::sort(order.begin(), order.end(), [this](const QString& a, const QString& b){
-        return priorities[a] > priorities[b];
-    });
+ScheduleProblem ScheduleManager::makeProblem() const {
+    ScheduleProblem p;
+    p.catalog = &catalog;
+    p.graph = &graph;
+    p.closure = &closure;
+    p.order = topoOrder;
+    p.priorities = priorities;
+    p.selected = selectedCourses;
+    p.creditLimits = creditLimits;
+    p.blocked = blockedTime;
+    p.creditTarget = creditTarget;
+    p.creditCap = creditCap;
+    return p;
+}
 
-    for (const auto& cid : order) {
-        if (!selectedCourses.contains(cid) && priorities.value(cid, 0) < 5) continue;
+std::shared_ptr<const ScheduleSnapshot> ScheduleManager::makeSnapshot() const {
+    return newSnapshot();
+}
 
-        const Course* pc = nullptr;
-        for (const auto& c : allCourses) {
-            if (c.id == cid) { pc = &c; break; }
-        }
-        if (!pc) continue;
-
-        int earliest = 0;
-        for (const auto& prereq : pc->prerequisites) {
-            for (const auto& sc : schedule) {
-                if (sc.courseId == prereq) {
-                    earliest = qMax(earliest, sc.semester + 1);
-                }
-            }
-        }
+std::shared_ptr<ScheduleSnapshot> ScheduleManager::newSnapshot() const {
+    auto snap = std::make_shared<ScheduleSnapshot>();
+    snap->catalog = catalog;
+    snap->graph = graph;
+    snap->closure = closure;
+    snap->problem = makeProblem();
+    snap->problem.catalog = &snap->catalog;
+    snap->problem.graph = &snap->graph;
+    snap->problem.closure = &snap->closure;
+    return snap;
+}
 
-        bool placed = false;
-        for (int sem = earliest; sem < 8 && !placed; ++sem) {
-            if (semCredit[sem] + pc->credit > creditLimits[sem]) continue;
-            if (!isPrerequisiteSatisfied(pc->id, sem)) continue;
-
-            for (const auto& off : pc->offerings) {
-                ScheduledCourse sc;
-                sc.courseId = cid;
-                sc.classId = off.id;
-                sc.semester = sem;
-
-                if (!checkTimeConflicts(sc)) {
-                    schedule.append(sc);
-                    semCredit[sem] += pc->credit;
-                    totalCredit += pc->credit;
-                    placed = true;
-                    break;
-                }
-            }
-        }
+std::shared_ptr<const ScheduleSnapshot> ScheduleManager::makeAlternativeSnapshot() const {
+    if (schedule.isEmpty()) return nullptr;
+    auto snap = newSnapshot();
+    // 贪心把 creditTarget 当作停止条件而不是上限；备选方案与当前方案比较，
+    // 只能在同样多的学分内取舍，否则无上限的枚举会在全部候选课程上搜索。
+    // 贪心方案越过了设定的 creditCap 时仍以 creditCap 为准
+    snap->problem.creditCap = creditCap > 0 ? qMin(creditCap, totalCredit) : totalCredit;
+    return snap;
+}
 
-        if (placed && totalCredit >= totalCreditLimit) {
-            break;
-        }
+bool ScheduleManager::generateSchedule() {
+    clearSchedule();
+    const ScheduleProblem problem = makeProblem();
+    if (!solver->solve(problem, lastSolution)) {
+        qWarning() << "generateSchedule: 求解失败" << solver->name();
+        return false;
     }
-
+    for (const auto& pl : lastSolution.placements)
+        place(pl);
     return true;
 }
 
-bool ScheduleManager::checkTimeConflicts(const ScheduledCourse& newSc) const {
-    const auto& noff = getOffering(newSc);
-
-    for (int day = 0; day < 7; ++day) {
-        if ((noff.times[day] & blockedTime[newSc.semester][day]) != 0) {
-            return true;
+bool ScheduleManager::applySolution(const ScheduleSolution& solution) {
+    for (const auto& pl : solution.placements) {
+        if (pl.course < 0 || pl.course >= catalog.courseCount() ||
+            pl.offering < catalog.offeringBegin(pl.course) || pl.offering >= catalog.offeringEnd(pl.course) ||
+            pl.semester < 0 || pl.semester >= creditLimits.size()) {
+            qWarning() << "applySolution: 方案与当前课程目录不匹配";
+            return false;
         }
     }
+    clearSchedule();
+    for (const auto& pl : solution.placements)
+        place(pl);
+    lastSolution = solution;
+    return true;
+}
+
+bool ScheduleManager::checkTimeConflicts(const Placement& newPl) const {
+    const SlotMask& m = catalog.offeringMask(newPl.offering);
+    return m.intersects(blockedTime[newPl.semester]) ||
+           occupancy[newPl.semester].conflicts(m, catalog.offeringWeeks(newPl.offering));
+}
+
+void ScheduleManager::place(const Placement& pl) {
+    schedule.append(pl);
+    placedSemester[pl.course] = pl.semester;
+    occupancy[pl.semester].add(catalog.offeringMask(pl.offering), catalog.offeringWeeks(pl.offering));
+    semCredits[pl.semester] += catalog.credit(pl.course);
+    totalCredit += catalog.credit(pl.course);
+}
+
+// 同一学期内已排课程互不重叠，因此直接清除对应位即可
+void ScheduleManager::unplace(int index) {
+    const Placement pl = schedule.takeAt(index);
+    placedSemester[pl.course] = -1;
+    occupancy[pl.semester].remove(catalog.offeringMask(pl.offering), catalog.offeringWeeks(pl.offering));
+    semCredits[pl.semester] -= catalog.credit(pl.course);
+    totalCredit -= catalog.credit(pl.course);
+}
+
+void ScheduleManager::clearSchedule() {
+    schedule.clear();
+    placedSemester.fill(-1);
+    occupancy.fill(WeekOccupancy());
+    semCredits.fill(0);
+    totalCredit = 0;
+}
+
+bool ScheduleManager::isCandidate(int course) const {
+    return selectedCourses.testBit(course) || priorities[course] >= 5;
+}
+
+bool ScheduleManager::canPlace(int course, int offering, int semester) const {
+    if (semCredits[semester] + catalog.credit(course) > creditLimits[semester])
+        return false;
+    return !checkTimeConflicts(Placement{course, offering, semester});
+}
 
-    for (const auto& sc : schedule) {
-        if (sc.semester != newSc.semester) continue;
-        const auto& eoff = getOffering(sc);
-        for (int day = 0; day < 7; ++day) {
-            if ((noff.times[day] & eoff.times[day]) != 0) {
+// 不移动已排课程，把 course 放进最早可行的学期与第一个不冲突的班次；
+// semesters 非空时只考虑其中标记的学期
+bool ScheduleManager::tryPlace(int course, const QVector<bool>* semesters) {
+    if (placedSemester[course] >= 0) return true;
+    if (topoRank[course] < 0) return false;   // 成环或先修未知
+    // 最长先修链决定的最早学期；超过学期数时不必再看先修课排在哪里
+    int earliest = closure.depth(course);
+    if (earliest >= creditLimits.size()) return false;
+    for (int pre : graph.prerequisites(course)) {
+        int s = placedSemester[pre];
+        if (s < 0) return false;
+        earliest = qMax(earliest, s + 1);
+    }
+    for (int sem = earliest; sem < creditLimits.size(); ++sem) {
+        if (semesters && !(*semesters)[sem]) continue;
+        for (int off = catalog.offeringBegin(course); off < catalog.offeringEnd(course); ++off) {
+            if (canPlace(course, off, sem)) {
+                place(Placement{course, off, sem});
                 return true;
             }
         }
     }
-
     return false;
 }
 
-const CourseOffering& ScheduleManager::getOffering(const ScheduledCourse& sc) const {
-    for (const auto& c : allCourses) {
-        if (c.id == sc.courseId) {
-            return c.getOffering(sc.classId);
+// course 刚被排入：此前因缺少它而未排的后继课程按拓扑序补排
+void ScheduleManager::placeDependents(int course) {
+    QVector<int> pending;
+    for (int d : allDependents(course)) {
+        if (placedSemester[d] < 0 && isCandidate(d)) pending.append(d);
+    }
+    std::sort(pending.begin(), pending.end(), [this](int a, int b) {
+        return topoRank[a] < topoRank[b];
+    });
+    for (int d : pending) {
+        // 停止规则与 GreedySolver 相同：未手动选中的课程只在总学分未达目标时补排
+        if (!selectedCourses.testBit(d) && totalCredit >= creditTarget) continue;
+        tryPlace(d);
+    }
+}
+
+// 按贪心的顺序与停止规则把仍未排入的候选课程补进释放出空间的学期
+void ScheduleManager::refill(const QVector<bool>& semesters) {
+    if (greedyOrderDirty) {
+        greedyOrder = topoOrder;
+        std::stable_sort(greedyOrder.begin(), greedyOrder.end(), [this](int a, int b) {
+            return priorities[a] > priorities[b];
+        });
+        greedyOrderDirty = false;
+    }
+    for (int c : greedyOrder) {
+        if (placedSemester[c] >= 0 || !isCandidate(c)) continue;
+        if (!selectedCourses.testBit(c) && totalCredit >= creditTarget) continue;
+        tryPlace(c, &semesters);
+    }
+}
+
+// 增量修改后让 getLastSolution() 与当前课表保持一致
+void ScheduleManager::syncSolution() {
+    lastSolution = ScheduleSolution();
+    lastSolution.placements = schedule;
+    lastSolution.credits = totalCredit;
+    for (const auto& pl : schedule)
+        lastSolution.score += qint64(priorities[pl.course]) * catalog.credit(pl.course);
+}
+
+bool ScheduleManager::insertCourse(const QString& courseId) {
+    const int c = catalog.courseIndex(courseId);
+    if (c < 0) return false;
+    selectedCourses.setBit(c);
+    if (placedSemester[c] >= 0) return true;
+    if (!tryPlace(c)) return false;
+    placeDependents(c);
+    syncSolution();
+    return true;
+}
+
+bool ScheduleManager::retractCourse(const QString& courseId) {
+    const int c = catalog.courseIndex(courseId);
+    if (c < 0) return false;
+    selectedCourses.clearBit(c);
+    // 仍因优先级而保留的课程不必移出
+    if (placedSemester[c] < 0 || isCandidate(c)) return true;
+
+    // 移出该课程及所有经先修关系依赖它、已排入的课程。
+    // 已排课程的先修课必然也已排入，所以这些课程正是闭包中已排入的后续课程
+    QVector<bool> affected(creditLimits.size(), false);
+    QVector<int> removed = allDependents(c);
+    removed.append(c);
+    for (int x : removed) {
+        if (placedSemester[x] < 0) continue;
+        affected[placedSemester[x]] = true;
+        for (int i = schedule.size() - 1; i >= 0; --i) {
+            if (schedule[i].course == x) { unplace(i); break; }
         }
     }
-    qWarning() << "getOffering: 未找到课程" << sc.courseId;
-    return allCourses.first().getOffering(sc.classId);
+    // 被移出的课程本身已不是候选，refill 不会把它放回
+    refill(affected);
+    syncSolution();
+    return true;
+}
+
+ScheduledCourse ScheduleManager::toScheduled(const Placement& pl) const {
+    ScheduledCourse sc;
+    sc.courseId = catalog.courseId(pl.course);
+    sc.classId = catalog.offeringId(pl.offering);
+    sc.semester = pl.semester;
+    return sc;
 }
 
 QList<ScheduledCourse> ScheduleManager::getCoursesForSemester(int sem) const {
     QList<ScheduledCourse> out;
-    for (const auto& sc : schedule) {
-        if (sc.semester == sem) out.append(sc);
+    for (const auto& pl : schedule) {
+        if (pl.semester == sem) out.append(toScheduled(pl));
+    }
+    return out;
+}
+
+QVector<Placement> ScheduleManager::getPlacementsForSemester(int sem) const {
+    QVector<Placement> out;
+    for (const auto& pl : schedule) {
+        if (pl.semester == sem) out.append(pl);
     }
     return out;
 }
 
 QList<ScheduledCourse> ScheduleManager::getAllScheduled() const {
-    return schedule;
+    QList<ScheduledCourse> out;
+    out.reserve(schedule.size());
+    for (const auto& pl : schedule)
+        out.append(toScheduled(pl));
+    return out;
 }
 
 void ScheduleManager::setCreditLimit(int semester, int limit) {
@@ -159,20 +357,22 @@ void ScheduleManager::setCreditLimit(int semester, int limit) {
 }
 
 void ScheduleManager::setPriority(const QString& courseId, int priority) {
-    if (priority >= 0 && priority <= 10) {
-        priorities[courseId] = priority;
+    int c = catalog.courseIndex(courseId);
+    if (c >= 0 && priority >= 0 && priority <= 10) {
+        priorities[c] = priority;
+        greedyOrderDirty = true;
     }
 }
 
 void ScheduleManager::addBlockedTime(int semester, int day, quint32 mask) {
     if (semester >= 0 && semester < 8 && day >= 0 && day < 7) {
-        blockedTime[semester][day] |= mask;
+        blockedTime[semester].day[day] |= static_cast<quint16>(mask);
     }
 }
 
 quint32 ScheduleManager::getBlockedTime(int semester, int day) const {
     if (semester >= 0 && semester < 8 && day >= 0 && day < 7) {
-        return blockedTime[semester][day];
+        return blockedTime[semester].day[day];
     }
     return 0;
 }
@@ -186,57 +386,100 @@ void ScheduleManager::removeCourse(const QString& courseId) {
 }
 
 int ScheduleManager::getCreditSum(int semester) const {
-    int sum = 0;
-    for (const auto& sc : schedule) {
-        if (sc.semester == semester) {
-            for (const auto& course : allCourses) {
-                if (course.id == sc.courseId) {
-                    sum += course.credit;
-                    break;
-                }
-            }
-        }
+    if (semester < 0 || semester >= semCredits.size()) return 0;
+    return semCredits[semester];
+}
+
+QVector<int> ScheduleManager::getFreeOfferings(int sem) const {
+    if (sem < 0 || sem >= occupancy.size()) return {};
+    return slotIndex.freeOfferings(occupancy[sem], blockedTime[sem], catalog);
+}
+
+QVector<int> ScheduleManager::getFittingCourses(int sem) const {
+    QVector<int> out;
+    // 班次按课程连续存放，下标升序时同一课程的班次相邻
+    for (int o : getFreeOfferings(sem)) {
+        const int c = catalog.offeringCourse(o);
+        if (placedSemester[c] < 0 && (out.isEmpty() || out.last() != c)) out.append(c);
     }
-    return sum;
+    return out;
 }
 
 bool ScheduleManager::hasTimeConflict(int semester) const {
-    for (const auto& sc : schedule) {
-        if (sc.semester != semester) continue;
-        const auto& off = getOffering(sc);
-        for (int day = 0; day < 7; ++day) {
-            if ((off.times[day] & blockedTime[semester][day]) != 0) {
-                return true;
-            }
-        }
-    }
-    return false;
+    if (semester < 0 || semester >= occupancy.size()) return false;
+    return occupancy[semester].any.intersects(blockedTime[semester]);
 }
 
 QList<QString> ScheduleManager::getPrerequisites(const QString& courseId) const {
-    for (const auto& course : allCourses) {
-        if (course.id == courseId) {
-            return course.prerequisites.toVector().toList();
+    int c = catalog.courseIndex(courseId);
+    if (c < 0) return {};
+    return catalog.prerequisiteIds(c);
+}
+
+// 闭包超出上限未建立时退回在先修图上遍历
+QVector<int> ScheduleManager::allPrerequisites(int course) const {
+    if (closure.isComplete()) {
+        const auto r = closure.ancestors(course);
+        return QVector<int>(r.begin(), r.end());
+    }
+    QVector<int> result;
+    QVector<bool> seen(catalog.courseCount(), false);
+    QVector<int> stack{course};
+    while (!stack.isEmpty()) {
+        for (int p : graph.prerequisites(stack.takeLast())) {
+            if (seen[p]) continue;
+            seen[p] = true;
+            result.append(p);
+            stack.append(p);
         }
     }
-    return {};
-}
-
-bool ScheduleManager::isPrerequisiteSatisfied(const QString& courseId, int semester) const {
-    for (const auto& course : allCourses) {
-        if (course.id == courseId) {
-            for (const auto& prereq : course.prerequisites) {
-                bool found = false;
-                for (const auto& sc : schedule) {
-                    if (sc.courseId == prereq && sc.semester < semester) {
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) return false;
-            }
-            return true;
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+QVector<int> ScheduleManager::allDependents(int course) const {
+    if (closure.isComplete()) {
+        const auto r = closure.descendants(course);
+        return QVector<int>(r.begin(), r.end());
+    }
+    QVector<int> result;
+    QVector<bool> seen(catalog.courseCount(), false);
+    QVector<int> stack{course};
+    while (!stack.isEmpty()) {
+        for (int d : graph.dependents(stack.takeLast())) {
+            if (seen[d]) continue;
+            seen[d] = true;
+            result.append(d);
+            stack.append(d);
         }
     }
-    return false;
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+QList<QString> ScheduleManager::getPrerequisiteChain(const QString& courseId) const {
+    const int c = catalog.courseIndex(courseId);
+    if (c < 0) return {};
+    QVector<int> pres = allPrerequisites(c);
+    // 深度小的在前，即按可修读的先后列出整条先修链
+    std::stable_sort(pres.begin(), pres.end(), [this](int a, int b) {
+        return closure.depth(a) < closure.depth(b);
+    });
+    QList<QString> ids;
+    ids.reserve(pres.size());
+    for (int p : pres) ids.append(catalog.courseId(p));
+    return ids;
+}
+
+QList<QString> ScheduleManager::getDependentCourses(const QString& courseId) const {
+    const int c = catalog.courseIndex(courseId);
+    if (c < 0) return {};
+    QList<QString> ids;
+    for (int d : allDependents(c)) ids.append(catalog.courseId(d));
+    return ids;
+}
+
+int ScheduleManager::getEarliestSemester(const QString& courseId) const {
+    const int c = catalog.courseIndex(courseId);
+    return c < 0 ? -1 : closure.depth(c);
 }
@@ -0,0 +1,86 @@
+#include "schedulejob.h"
+#include <QThread>
+
+ScheduleJob::ScheduleJob(std::shared_ptr<const ScheduleSnapshot> snap,
+                         std::unique_ptr<ScheduleSolver> s, QObject* parent)
+    : QObject(parent),
+    snapshot(std::move(snap)),
+    solver(std::move(s)),
+    problem(snapshot->problem)
+{
+    problem.monitor = this;
+}
+
+ScheduleJob::~ScheduleJob() {
+    cancelRequested.store(true);
+    if (thread) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+void ScheduleJob::start() {
+    if (thread) return;
+    thread = QThread::create([this] { run(); });
+    thread->start();
+}
+
+void ScheduleJob::cancel() {
+    if (cancelRequested.exchange(true)) return;
+    // 被节流暂存的最优解此后不会再有检查点来补发，在这里直接交出
+    flushPending(true);
+}
+
+bool ScheduleJob::isRunning() const {
+    return thread && thread->isRunning();
+}
+
+void ScheduleJob::run() {
+    {
+        QMutexLocker lock(&reportMutex);
+        sinceReport.start();
+    }
+    ScheduleSolution solution;
+    const bool ok = solver->solve(problem, solution);
+    if (cancelRequested.load()) {
+        emit canceled();
+        return;
+    }
+    emit progressChanged(100);
+    emit finished(solution, ok);
+}
+
+bool ScheduleJob::isCanceled() const {
+    return cancelRequested.load(std::memory_order_relaxed);
+}
+
+// 只在百分比变化时发信号，避免检查点过密时塞满事件队列。
+// 检查点也负责补发节流间隔内暂存的最优解
+void ScheduleJob::progress(int percent) {
+    if (lastPercent.exchange(percent, std::memory_order_relaxed) != percent)
+        emit progressChanged(percent);
+    if (hasPending.load(std::memory_order_relaxed)) flushPending(false);
+}
+
+void ScheduleJob::improved(const ScheduleSolution& best) {
+    if (cancelRequested.load(std::memory_order_relaxed)) return;
+    {
+        QMutexLocker lock(&reportMutex);
+        if (best.score <= reportedScore) return;
+        if (hasPending.load() && best.score <= pending.score) return;
+        pending = best;
+        hasPending.store(true);
+    }
+    flushPending(false);
+}
+
+// 持锁发信号：排队连接只是投递事件，同时保证各次报告按分数递增的顺序到达
+void ScheduleJob::flushPending(bool force) {
+    QMutexLocker lock(&reportMutex);
+    if (!hasPending.load()) return;
+    if (!force && sinceReport.isValid() && sinceReport.elapsed() < 100) return;
+    hasPending.store(false);
+    reportedScore = pending.score;
+    sinceReport.restart();
+    emit bestChanged(pending);
+}
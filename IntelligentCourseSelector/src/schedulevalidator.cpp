@@ -0,0 +1,173 @@
+#include "schedulevalidator.h"
+#include "workstealingpool.h"
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+namespace {
+
+struct Entry {
+    int course;
+    int offering;                // 班号不存在时为 -1
+    int semester;
+};
+
+} // namespace
+
+ScheduleValidator::ScheduleValidator(const CourseCatalog& catalog)
+    : catalog(catalog)
+{
+}
+
+QString ScheduleValidator::describe(int course) const {
+    const QString name = catalog.courseName(course);
+    const QString id = catalog.courseId(course);
+    return name.isEmpty() ? id : QString("%1（%2）").arg(id, name);
+}
+
+ValidationResult ScheduleValidator::validate(const QList<ScheduledCourse>& schedule) const {
+    ValidationResult res;
+    QVector<Entry> entries;
+    entries.reserve(schedule.size());
+    for (const auto& sc : schedule) {
+        if (sc.semester < 0) continue;   // 未排入的课程
+        const int c = catalog.courseIndex(sc.courseId);
+        if (c < 0) {
+            res.errors.append(QString("课程 %1 不存在于课程目录").arg(sc.courseId));
+            continue;
+        }
+        res.credits += catalog.credit(c);
+        if (sc.semester >= MaxSemesters) {
+            res.errors.append(QString("课程 %1 的学期 %2 超出范围").arg(describe(c)).arg(sc.semester));
+            continue;
+        }
+        const int o = catalog.offeringIndex(c, sc.classId);
+        if (o < 0)
+            res.errors.append(QString("课程 %1 的班号 %2 不在 offerings 中").arg(describe(c), sc.classId));
+        entries.append(Entry{c, o, sc.semester});
+    }
+
+    // 按课程下标排序后二分查找先修课的学期，相邻相同即为重复
+    QVector<Entry> byCourse = entries;
+    std::stable_sort(byCourse.begin(), byCourse.end(),
+                     [](const Entry& a, const Entry& b) { return a.course < b.course; });
+    for (int i = 1; i < byCourse.size(); ++i) {
+        if (byCourse[i].course == byCourse[i - 1].course &&
+            (i == 1 || byCourse[i - 2].course != byCourse[i].course))
+            res.errors.append(QString("课程 %1 重复出现").arg(describe(byCourse[i].course)));
+    }
+    auto semesterOf = [&byCourse](int course) {
+        auto it = std::lower_bound(byCourse.cbegin(), byCourse.cend(), course,
+                                   [](const Entry& e, int c) { return e.course < c; });
+        return it != byCourse.cend() && it->course == course ? it->semester : -1;
+    };
+
+    for (const Entry& e : entries) {
+        if (catalog.hasUnresolvedPrerequisite(e.course)) {
+            for (const QString& pre : catalog.prerequisiteIds(e.course)) {
+                if (catalog.courseIndex(pre) < 0)
+                    res.errors.append(QString("课程 %1 缺少先修课 %2").arg(describe(e.course), pre));
+            }
+        }
+        for (int pre : catalog.prerequisites(e.course)) {
+            const int s = semesterOf(pre);
+            if (s < 0) {
+                res.errors.append(QString("课程 %1 缺少先修课 %2").arg(describe(e.course), describe(pre)));
+            } else if (s >= e.semester) {
+                res.errors.append(QString("课程 %1 的先修课 %2 学期 %3 需早于本课学期 %4")
+                                      .arg(describe(e.course), describe(pre))
+                                      .arg(s).arg(e.semester));
+            }
+        }
+    }
+
+    QVector<WeekOccupancy> occupancy;
+    for (int j = 0; j < entries.size(); ++j) {
+        const Entry& e = entries[j];
+        if (e.offering < 0) continue;
+        if (occupancy.size() <= e.semester) occupancy.resize(e.semester + 1);
+        const SlotMask& mask = catalog.offeringMask(e.offering);
+        const quint32 weeks = catalog.offeringWeeks(e.offering);
+        if (occupancy[e.semester].conflicts(mask, weeks)) {
+            for (int i = 0; i < j; ++i) {
+                const Entry& p = entries[i];
+                if (p.semester != e.semester || p.offering < 0) continue;
+                if (mask.intersects(catalog.offeringMask(p.offering)) &&
+                    (weeks & catalog.offeringWeeks(p.offering)) != 0)
+                    res.errors.append(QString("学期 %1 内 %2 与 %3 时间冲突")
+                                          .arg(e.semester).arg(describe(p.course), describe(e.course)));
+            }
+        }
+        occupancy[e.semester].add(mask, weeks);
+    }
+    return res;
+}
+
+QVector<ValidationResult> ScheduleValidator::run(const QVector<QByteArray>& documents) const {
+    // 单份方案只需几十微秒，每个任务处理一段连续文档以摊薄提交开销
+    constexpr int Chunk = 64;
+    QVector<ValidationResult> results(documents.size());
+    WorkStealingPool pool(threads);
+    for (int begin = 0; begin < documents.size(); begin += Chunk) {
+        const int end = qMin(begin + Chunk, int(documents.size()));
+        pool.submit([this, &documents, &results, begin, end](int) {
+            for (int i = begin; i < end; ++i) {
+                QString studentId;
+                QList<ScheduledCourse> schedule;
+                if (!parseDocument(documents[i], studentId, schedule)) {
+                    results[i].errors.append("排课方案格式错误");
+                    continue;
+                }
+                results[i] = validate(schedule);
+                results[i].studentId = studentId;
+            }
+        });
+    }
+    pool.waitForDone();
+    return results;
+}
+
+bool ScheduleValidator::parseDocument(const QByteArray& data, QString& studentId,
+                                      QList<ScheduledCourse>& out) {
+    QJsonParseError err;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &err);
+    if (err.error != QJsonParseError::NoError || doc.isNull()) {
+        qWarning() << "排课方案格式错误：" << err.errorString();
+        return false;
+    }
+
+    QJsonArray entries;
+    studentId.clear();
+    if (doc.isArray()) {
+        entries = doc.array();
+    } else {
+        QJsonObject obj = doc.object();
+        studentId = obj["student_id"].toString();
+        entries = obj["schedule"].toArray();
+    }
+
+    out.clear();
+    out.reserve(entries.size());
+    for (const auto& v : entries) {
+        QJsonObject e = v.toObject();
+        ScheduledCourse sc;
+        sc.courseId = e.contains("course_id") ? e["course_id"].toString() : e["id"].toString();
+        if (sc.courseId.isEmpty()) continue;
+        sc.classId = e.contains("class_id") ? e["class_id"].toString() : e["class"].toString();
+        sc.semester = e["semester"].toInt(-1);
+        out.append(sc);
+    }
+    return true;
+}
+
+QByteArray ScheduleValidator::resultToJson(const ValidationResult& r) {
+    QJsonObject obj;
+    obj["student_id"] = r.studentId;
+    obj["valid"] = r.isValid();
+    obj["credits"] = r.credits;
+    if (!r.isValid())
+        obj["errors"] = QJsonArray::fromStringList(r.errors);
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
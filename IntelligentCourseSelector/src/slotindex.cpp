@@ -0,0 +1,56 @@
+#include "slotindex.h"
+#include "course.h"
+
+SlotIndex::SlotIndex(const CourseCatalog& catalog)
+    : offerings(catalog.offeringCount()),
+    words((catalog.offeringCount() + 63) / 64)
+{
+    bits.fill(0, qsizetype(Bits) * words);
+    noWeeks.fill(0, words);
+    for (int o = 0; o < offerings; ++o) {
+        const quint64 bit = quint64(1) << (o % 64);
+        catalog.offeringMask(o).anyBit([&](int b) {
+            bits[qsizetype(b) * words + o / 64] |= bit;
+            return false;
+        });
+        if (catalog.offeringWeeks(o) == 0) noWeeks[o / 64] |= bit;
+    }
+}
+
+QVector<int> SlotIndex::freeOfferings(const WeekOccupancy& occupied, const SlotMask& blocked,
+                                      const CourseCatalog& catalog) const {
+    // free 从全集开始，逐个被占节次做 ANDNOT；verify 收集需要按周次校验的候选
+    QVector<quint64> free(words, ~quint64(0));
+    if (offerings % 64) free[words - 1] = (quint64(1) << (offerings % 64)) - 1;
+    QVector<quint64> verify(words, 0);
+
+    blocked.anyBit([&](int b) {
+        const quint64* s = slot(b);
+        for (int w = 0; w < words; ++w) free[w] &= ~s[w];
+        return false;
+    });
+    SlotMask rest = occupied.any;
+    rest.remove(blocked);
+    rest.anyBit([&](int b) {
+        const quint64* s = slot(b);
+        if (occupied.weeks[b] == CourseOffering::AllWeeks) {
+            // 除从不上课的班次外，在该节次上课的班次必然与之周次相交
+            for (int w = 0; w < words; ++w) free[w] &= ~(s[w] & ~noWeeks[w]);
+        } else {
+            for (int w = 0; w < words; ++w) verify[w] |= s[w];
+        }
+        return false;
+    });
+
+    QVector<int> out;
+    for (int w = 0; w < words; ++w) {
+        for (quint64 v = free[w]; v; v &= v - 1) {
+            const int o = w * 64 + int(qCountTrailingZeroBits(v));
+            if ((verify[w] >> (o % 64)) & 1) {
+                if (occupied.conflicts(catalog.offeringMask(o), catalog.offeringWeeks(o))) continue;
+            }
+            out.append(o);
+        }
+    }
+    return out;
+}
@@ -0,0 +1,1211 @@
+#include "solver.h"
+#include "workstealingpool.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QtGlobal>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+SolverState::SolverState(const ScheduleProblem& p)
+    : problem(p),
+    semCredit(p.semesterCount(), 0),
+    occupancy(p.semesterCount()),
+    placedSemester(p.catalog->courseCount(), -1),
+    placedOffering(p.catalog->courseCount(), -1)
+{
+    // 屏蔽时间预先并入占用，canPlace 只需检查一个结构
+    for (int s = 0; s < p.semesterCount(); ++s)
+        occupancy[s].add(p.blocked[s], CourseOffering::AllWeeks);
+}
+
+int SolverState::earliestSemester(int course) const {
+    int earliest = 0;
+    for (int pre : problem.graph->prerequisites(course)) {
+        int s = placedSemester[pre];
+        if (s < 0) return -1;
+        earliest = qMax(earliest, s + 1);
+    }
+    return earliest;
+}
+
+bool SolverState::canPlace(int course, int offering, int semester) const {
+    if (semCredit[semester] + problem.catalog->credit(course) > problem.creditLimits[semester])
+        return false;
+    return !occupancy[semester].conflicts(problem.catalog->offeringMask(offering),
+                                          problem.catalog->offeringWeeks(offering));
+}
+
+void SolverState::place(const Placement& pl) {
+    const int credit = problem.catalog->credit(pl.course);
+    semCredit[pl.semester] += credit;
+    totalCredit += credit;
+    score += problem.value(pl.course);
+    occupancy[pl.semester].add(problem.catalog->offeringMask(pl.offering),
+                               problem.catalog->offeringWeeks(pl.offering));
+    placedSemester[pl.course] = pl.semester;
+    placedOffering[pl.course] = pl.offering;
+}
+
+void SolverState::unplace(const Placement& pl) {
+    const int credit = problem.catalog->credit(pl.course);
+    semCredit[pl.semester] -= credit;
+    totalCredit -= credit;
+    score -= problem.value(pl.course);
+    occupancy[pl.semester].remove(problem.catalog->offeringMask(pl.offering),
+                                  problem.catalog->offeringWeeks(pl.offering));
+    placedSemester[pl.course] = -1;
+    placedOffering[pl.course] = -1;
+}
+
+bool GreedySolver::solve(const ScheduleProblem& p, ScheduleSolution& out) {
+    const CourseCatalog& cat = *p.catalog;
+    SolverState st(p);
+    out = ScheduleSolution();
+
+    auto order = p.order;
+    std::stable_sort(order.begin(), order.end(), [&p](int a, int b){
+        return p.priorities[a] > p.priorities[b];
+    });
+
+    for (int i = 0; i < order.size(); ++i) {
+        const int c = order[i];
+        if (p.monitor && (i & 255) == 0) {
+            if (p.monitor->isCanceled()) return false;
+            p.monitor->progress(int(qint64(i) * 100 / order.size()));
+        }
+        if (!p.isCandidate(c) || p.tooDeep(c)) continue;
+        // 总学分达到目标后只再排手动选中的课程，增量排课（ScheduleManager::refill）同此规则
+        if (!p.selected.testBit(c) && st.totalCredit >= p.creditTarget) continue;
+
+        // 先修课未排时与原实现一致：找不到可排学期，直接跳过
+        int earliest = st.earliestSemester(c);
+        if (earliest < 0) continue;
+
+        bool placed = false;
+        for (int sem = earliest; sem < p.semesterCount() && !placed; ++sem) {
+            for (int off = cat.offeringBegin(c); off < cat.offeringEnd(c); ++off) {
+                if (st.canPlace(c, off, sem)) {
+                    Placement pl{c, off, sem};
+                    st.place(pl);
+                    out.placements.append(pl);
+                    placed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    out.score = st.score;
+    out.credits = st.totalCredit;
+    return true;
+}
+
+namespace {
+
+// 搜索中的一个决策：一门课程及其可选班次（时间完全相同的班次只保留一个）
+struct Item {
+    int course;
+    int credit;
+    qint64 value;
+    int minSemester;         // 由先修链长度决定的最早学期
+    QVector<int> offerings;
+};
+
+// 搜索模型：决策顺序与定界用的静态数据，构建一次后可被多个线程共享
+struct SearchModel {
+    SearchModel(const ScheduleProblem& p, quint32 seed);
+
+    const ScheduleProblem& p;
+    QVector<Item> items;          // 决策顺序，满足拓扑序
+    QVector<int> itemOf;          // 课程下标 -> items 下标，-1 表示不参与
+    QVector<int> byDensity;       // items 下标，按单位学分价值（即优先级）降序
+    QVector<qint64> suffixValue;  // items[i..] 的价值和
+};
+
+// 同价值课程的展开顺序由种子决定；种子为 0 时按原拓扑序
+static quint32 tieBreak(quint32 seed, int course) {
+    if (seed == 0) return ~quint32(course);
+    quint32 h = seed ^ (quint32(course) * 0x9E3779B9u);
+    h ^= h >> 16; h *= 0x85EBCA6Bu;
+    h ^= h >> 13; h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+SearchModel::SearchModel(const ScheduleProblem& p, quint32 seed)
+    : p(p)
+{
+    const CourseCatalog& cat = *p.catalog;
+    const int semCount = p.semesterCount();
+    const int n = cat.courseCount();
+
+    // 沿拓扑序筛掉静态不可排的课程：先修课被筛掉、学分超限、或所有班次都撞上屏蔽时间
+    QVector<int> minSem(n, 0);
+    QVector<bool> kept(n, false);
+    QVector<Item> pool;
+    for (int c : p.order) {
+        if (!p.isCandidate(c) || p.tooDeep(c)) continue;
+        bool ok = true;
+        int earliest = 0;
+        for (int pre : p.graph->prerequisites(c)) {
+            if (!kept[pre]) { ok = false; break; }
+            earliest = qMax(earliest, minSem[pre] + 1);
+        }
+        const int credit = cat.credit(c);
+        if (!ok || earliest >= semCount) continue;
+        if (p.creditCap > 0 && credit > p.creditCap) continue;
+
+        Item item{c, credit, p.value(c), earliest, {}};
+        for (int o = cat.offeringBegin(c); o < cat.offeringEnd(c); ++o) {
+            const SlotMask& m = cat.offeringMask(o);
+            bool duplicate = false;
+            for (int prev : item.offerings) {
+                if (cat.offeringWeeks(prev) == cat.offeringWeeks(o) &&
+                    std::equal(m.day, m.day + 8, cat.offeringMask(prev).day)) { duplicate = true; break; }
+            }
+            if (duplicate) continue;
+            for (int s = earliest; s < semCount; ++s) {
+                if (credit <= p.creditLimits[s] && !m.intersects(p.blocked[s])) {
+                    item.offerings.append(o);
+                    break;
+                }
+            }
+        }
+        if (item.offerings.isEmpty()) continue;
+
+        kept[c] = true;
+        minSem[c] = earliest;
+        pool.append(item);
+    }
+
+    // 在保留的课程上重新做一次拓扑排序，同层优先展开价值高的课程
+    QVector<int> poolOf(n, -1);
+    for (int i = 0; i < pool.size(); ++i) poolOf[pool[i].course] = i;
+    QVector<int> indeg(pool.size(), 0);
+    for (int i = 0; i < pool.size(); ++i)
+        indeg[i] = p.graph->prerequisites(pool[i].course).size();
+
+    using Key = std::pair<std::pair<qint64, quint32>, int>;   // ((价值, 次序), 下标)
+    std::priority_queue<Key> ready;
+    auto push = [&](int i) {
+        ready.push({{pool[i].value, tieBreak(seed, pool[i].course)}, i});
+    };
+    for (int i = 0; i < pool.size(); ++i)
+        if (indeg[i] == 0) push(i);
+
+    itemOf.fill(-1, n);
+    while (!ready.empty()) {
+        int i = ready.top().second;
+        ready.pop();
+        itemOf[pool[i].course] = items.size();
+        items.append(pool[i]);
+        for (int d : p.graph->dependents(pool[i].course)) {
+            int j = poolOf[d];
+            if (j >= 0 && --indeg[j] == 0) push(j);
+        }
+    }
+
+    suffixValue.fill(0, items.size() + 1);
+    for (int i = items.size() - 1; i >= 0; --i)
+        suffixValue[i] = suffixValue[i + 1] + items[i].value;
+
+    byDensity.resize(items.size());
+    for (int i = 0; i < items.size(); ++i) byDensity[i] = i;
+    std::stable_sort(byDensity.begin(), byDensity.end(), [this](int a, int b){
+        return this->p.priorities[items[a].course] > this->p.priorities[items[b].course];
+    });
+}
+
+// 并行搜索共享的当前最优解。子树用路径键排序（每层 16 位，按深度优先先后递增），
+// 同分时取键小者，所以无论线程如何调度，最终胜出的方案都相同
+struct SharedIncumbent {
+    std::atomic<qint64> score{0};
+    std::mutex mutex;
+    quint64 key = ~quint64(0);          // 以下成员受 mutex 保护
+    ScheduleSolution solution;
+    bool found = false;
+    SolveMonitor* monitor = nullptr;
+
+    void offer(const ScheduleSolution& s, quint64 k) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (found && (s.score < score.load() || (s.score == score.load() && k >= key))) return;
+        const bool better = !found || s.score > score.load();
+        solution = s;
+        key = k;
+        found = true;
+        score.store(s.score);
+        if (monitor && better && s.score > 0) monitor->improved(solution);
+    }
+
+    // 上界为 bound、路径键不小于 minKey 的子树能否被剪掉
+    bool dominates(qint64 bound, quint64 minKey) {
+        qint64 g = score.load(std::memory_order_relaxed);
+        if (bound != g) return bound < g;
+        std::lock_guard<std::mutex> lock(mutex);
+        return found && (bound < score.load() || key < minKey);
+    }
+};
+
+// 单线程深度优先搜索；并行时每个子树各用一个实例
+class SearchWorker {
+public:
+    explicit SearchWorker(const SearchModel& m);
+
+    // 从第 level 个决策开始搜索：先重放前缀上的排课，前 level 个决策中不在前缀里的视为跳过
+    void reset(const QVector<Placement>& prefix, int level);
+
+    // 第 i 个决策在当前状态下的全部放置方案（不含“跳过”）
+    void options(int i, QVector<Placement>& out) const;
+    qint64 upperBound(int from);
+    void dfs(int i);
+    // 第 i 个决策排除 banned 中的选择（offering 为 -1 表示“跳过”）后继续搜索
+    void dfsExcluding(int i, const QVector<Placement>& banned);
+
+    qint64 score() const { return st.score; }
+
+    // 并行时共享的最优解；shareBound 为 false 时只上报不参与剪枝
+    SharedIncumbent* incumbent = nullptr;
+    quint64 taskKey = 0;
+    bool shareBound = false;
+    std::atomic<bool>* stop = nullptr;
+    const QElapsedTimer* timer = nullptr;
+    qint64 budgetMs = 0;
+    qint64 nodeLimit = 0;            // 0 表示不限
+    bool reportImproved = true;      // 未共享最优解时是否向 monitor 报告更优方案
+    // 枚举时只接受与 avoid 中每个方案至少相差 minDistance 门课程的方案
+    const QVector<ScheduleSolution>* avoid = nullptr;
+    int minDistance = 0;
+
+    ScheduleSolution best;
+    qint64 nodes = 0;
+    bool aborted = false;
+
+private:
+    bool feasibleNow(const Item& item, int index) const;
+    bool shouldStop();
+    bool diverse() const;
+
+    // 维护上界用的候选链表：decide 把第 i 个决策移出；drop 移出 i 及依赖它的全部课程
+    // （withSelf 为 false 时只移出后者）；undo 按相反顺序恢复到 trail 的给定长度
+    void decide(int i);
+    void drop(int i, bool withSelf);
+    void undo(int mark);
+    void unlink(int i) {
+        next[prev[i]] = next[i];
+        prev[next[i]] = prev[i];
+        listed[i] = false;
+        trail.append(i);
+    }
+
+    const SearchModel& m;
+    const ScheduleProblem& p;
+    SolverState st;
+    QVector<Placement> current;
+
+    // 按优先级降序串起尚未决策、且在当前路径上仍可能排入的 items（双向链表，哨兵为 items.size()），
+    // 上界只需沿链表走到剩余学分容量用完为止。沿搜索路径只会继续放入课程，
+    // 此刻排不进的课程在整棵子树中都排不进，因此移出后直到回溯才恢复。
+    // 不变式：未决策而被移出的课程，依赖它的课程也都已移出
+    QVector<int> next;
+    QVector<int> prev;
+    QVector<bool> listed;
+    QVector<int> trail;         // 依次移出链表的 items 下标
+    QVector<int> pending;       // drop 遍历后续课程用的栈
+    QVector<int> unplaceable;   // upperBound 本次发现排不进的课程
+};
+
+SearchWorker::SearchWorker(const SearchModel& m)
+    : m(m), p(m.p), st(m.p)
+{
+    const int n = m.items.size();
+    next.resize(n + 1);
+    prev.resize(n + 1);
+    listed.fill(true, n);
+    int last = n;
+    for (int i : m.byDensity) {
+        next[last] = i;
+        prev[i] = last;
+        last = i;
+    }
+    next[last] = n;
+    prev[n] = last;
+}
+
+void SearchWorker::reset(const QVector<Placement>& prefix, int level) {
+    undo(0);
+    for (const auto& pl : current) st.unplace(pl);
+    current.clear();
+    for (const auto& pl : prefix) {
+        st.place(pl);
+        current.append(pl);
+    }
+    for (int i = 0; i < level; ++i) {
+        const bool wasListed = listed[i];
+        decide(i);
+        if (wasListed && st.placedSemester[m.items[i].course] < 0) drop(i, false);
+    }
+}
+
+void SearchWorker::decide(int i) {
+    if (listed[i]) unlink(i);
+}
+
+// i 不可能再排入（被跳过或已无可放位置），依赖它的课程也都不可能。
+// 由不变式，遍历到已移出的后续课程即可停止
+void SearchWorker::drop(int i, bool withSelf) {
+    if (withSelf) {
+        if (!listed[i]) return;
+        unlink(i);
+    }
+    pending.append(m.items[i].course);
+    while (!pending.isEmpty()) {
+        const int c = pending.takeLast();
+        for (int d : p.graph->dependents(c)) {
+            const int j = m.itemOf[d];
+            if (j < 0 || !listed[j]) continue;
+            unlink(j);
+            pending.append(d);
+        }
+    }
+}
+
+void SearchWorker::undo(int mark) {
+    while (trail.size() > mark) {
+        const int i = trail.takeLast();
+        next[prev[i]] = i;
+        prev[next[i]] = i;
+        listed[i] = true;
+    }
+}
+
+bool SearchWorker::shouldStop() {
+    ++nodes;
+    if (nodeLimit > 0 && nodes > nodeLimit) return true;
+    if ((nodes & 1023) == 0) {
+        if (stop && stop->load(std::memory_order_relaxed)) return true;
+        if (p.monitor && p.monitor->isCanceled()) {
+            if (stop) stop->store(true, std::memory_order_relaxed);
+            return true;
+        }
+        if (timer && timer->elapsed() > budgetMs) {
+            if (stop) stop->store(true, std::memory_order_relaxed);
+            return true;
+        }
+        // 搜索空间未知，进度按已用时间占预算的比例估计
+        if (p.monitor && timer && budgetMs > 0)
+            p.monitor->progress(int(qMin<qint64>(99, timer->elapsed() * 100 / budgetMs)));
+    }
+    return false;
+}
+
+void SearchWorker::options(int i, QVector<Placement>& out) const {
+    out.clear();
+    const Item& item = m.items[i];
+    int earliest = st.earliestSemester(item.course);
+    if (earliest < 0) return;
+    if (p.creditCap > 0 && st.totalCredit + item.credit > p.creditCap) return;
+    for (int s = qMax(earliest, item.minSemester); s < p.semesterCount(); ++s) {
+        for (int o : item.offerings) {
+            if (st.canPlace(item.course, o, s))
+                out.append(Placement{item.course, o, s});
+        }
+    }
+}
+
+// 在当前占用下，未决策的课程是否还有至少一个 (学期, 班次) 可放
+bool SearchWorker::feasibleNow(const Item& item, int index) const {
+    int earliest = item.minSemester;
+    for (int pre : p.graph->prerequisites(item.course)) {
+        if (m.itemOf[pre] < index) {
+            // 先修课已决策：未排则本课无法排
+            int s = st.placedSemester[pre];
+            if (s < 0) return false;
+            earliest = qMax(earliest, s + 1);
+        }
+    }
+    for (int s = earliest; s < p.semesterCount(); ++s) {
+        for (int o : item.offerings) {
+            if (st.canPlace(item.course, o, s)) return true;
+        }
+    }
+    return false;
+}
+
+// 分数上界：忽略剩余课程之间的冲突，只保留位图可行性，
+// 再按优先级（单位学分价值）对剩余学分容量做分数背包。
+// 候选链表已去掉决策过的课程和当前路径上排不进的课程，遍历到容量用完即止；
+// 途中发现排不进的课程连同其后续一并移出，同一路径上不再重复检查
+qint64 SearchWorker::upperBound(int from) {
+    qint64 capacity = 0;
+    for (int s = 0; s < p.semesterCount(); ++s)
+        capacity += qMax(0, p.creditLimits[s] - st.semCredit[s]);
+    if (p.creditCap > 0)
+        capacity = qMin<qint64>(capacity, p.creditCap - st.totalCredit);
+
+    const int sentinel = m.items.size();
+    qint64 bound = 0;
+    for (int i = next[sentinel]; i != sentinel && capacity > 0; i = next[i]) {
+        if (i < from) continue;     // 只按前缀重放、尚未移出的决策
+        const Item& item = m.items[i];
+        if (!feasibleNow(item, from)) {
+            unplaceable.append(i);
+            continue;
+        }
+        if (item.credit <= capacity) {
+            bound += item.value;
+            capacity -= item.credit;
+        } else {
+            bound += qint64(p.priorities[item.course]) * capacity;
+            capacity = 0;
+        }
+    }
+    for (int i : unplaceable) drop(i, true);
+    unplaceable.clear();
+    return bound;
+}
+
+// 只有放入课程时才递归，“跳过”分支在本层循环中展开，
+// 递归深度因此不超过一个方案中的课程数，而不是候选课程总数
+void SearchWorker::dfs(int i) {
+    auto pruned = [this](qint64 bound) {
+        if (bound <= best.score) return true;
+        return shareBound && incumbent->dominates(bound, taskKey);
+    };
+    const int mark = trail.size();
+    QVector<Placement> opts;
+    for (;; ++i) {
+        if (aborted || shouldStop()) {
+            aborted = true;
+            break;
+        }
+
+        if (st.score > best.score && diverse()) {
+            best.placements = current;
+            best.score = st.score;
+            best.credits = st.totalCredit;
+            if (incumbent) incumbent->offer(best, taskKey);
+            else if (p.monitor && reportImproved) p.monitor->improved(best);
+        }
+        if (i == m.items.size()) break;
+
+        if (pruned(st.score + m.suffixValue[i])) break;
+        if (pruned(st.score + upperBound(i))) break;
+
+        decide(i);
+        options(i, opts);
+        for (const auto& pl : opts) {
+            st.place(pl);
+            current.append(pl);
+            dfs(i + 1);
+            current.removeLast();
+            st.unplace(pl);
+            if (aborted) break;
+        }
+        if (aborted) break;
+        drop(i, false);
+    }
+    undo(mark);
+}
+
+void SearchWorker::dfsExcluding(int i, const QVector<Placement>& banned) {
+    auto isBanned = [&banned](int offering, int semester) {
+        for (const auto& b : banned) {
+            if (b.offering == offering && b.semester == semester) return true;
+        }
+        return false;
+    };
+    const bool skipBanned = isBanned(-1, -1);
+    if (i == m.items.size()) {
+        if (!skipBanned) dfs(i);
+        return;
+    }
+    const int mark = trail.size();
+    decide(i);
+    QVector<Placement> opts;
+    options(i, opts);
+    for (const auto& pl : opts) {
+        if (isBanned(pl.offering, pl.semester)) continue;
+        st.place(pl);
+        current.append(pl);
+        dfs(i + 1);
+        current.removeLast();
+        st.unplace(pl);
+        if (aborted) break;
+    }
+    // “跳过”分支的第一个节点即当前状态本身，禁止跳过时当前状态也不能作为方案
+    if (!aborted && !skipBanned) {
+        drop(i, false);
+        dfs(i + 1);
+    }
+    undo(mark);
+}
+
+// 当前状态与 avoid 中每个方案的差异：只排在一方的课程，加上两方都排了但学期或班次不同的课程
+bool SearchWorker::diverse() const {
+    if (!avoid || minDistance <= 0) return true;
+    for (const auto& other : *avoid) {
+        int common = 0, same = 0;
+        for (const auto& pl : other.placements) {
+            const int s = st.placedSemester[pl.course];
+            if (s < 0) continue;
+            ++common;
+            if (s == pl.semester && st.placedOffering[pl.course] == pl.offering) ++same;
+        }
+        if (current.size() + other.placements.size() - common - same < minDistance) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool BranchBoundSolver::solve(const ScheduleProblem& p, ScheduleSolution& out) {
+    SearchModel model(p, seed);
+    SearchWorker worker(model);
+    QElapsedTimer timer;
+    timer.start();
+    worker.timer = &timer;
+    worker.budgetMs = budgetMs;
+
+    if (!model.items.isEmpty())
+        worker.dfs(0);
+    out = worker.best;
+    out.optimal = !worker.aborted;
+    out.nodes = worker.nodes;
+    return true;
+}
+
+bool ParallelBranchBoundSolver::solve(const ScheduleProblem& p, ScheduleSolution& out) {
+    const SearchModel model(p, seed);
+    out = ScheduleSolution();
+    if (model.items.isEmpty()) {
+        out.optimal = true;
+        return true;
+    }
+
+    // 路径键每层占 16 位（单层分支数远小于 65536），因此最多拆 4 层
+    const int depth = qMin(qMin(splitDepth, 4), int(model.items.size()));
+    SharedIncumbent incumbent;
+    incumbent.monitor = p.monitor;
+    std::atomic<bool> stop{false};
+    std::atomic<qint64> totalNodes{0};
+    std::atomic<bool> incomplete{false};
+    QElapsedTimer timer;
+    timer.start();
+
+    WorkStealingPool pool(threads);
+
+    // 前 depth 层按 (学期, 班次) 方案拆成子任务，其余层在子任务内串行搜索
+    std::function<void(int, QVector<Placement>, int, quint64)> expand;
+    expand = [&](int worker, QVector<Placement> prefix, int level, quint64 key) {
+        if (stop.load()) { incomplete = true; return; }
+        SearchWorker w(model);
+        // 设置了节点预算时不再受时间预算约束，否则截断点会随机器负载变化
+        w.timer = nodeBudget > 0 ? nullptr : &timer;
+        w.budgetMs = budgetMs;
+        w.stop = &stop;
+        w.nodeLimit = nodeBudget;
+        w.incumbent = &incumbent;
+        w.taskKey = key;
+        // 设置了节点预算时各子树独立定界，保证截断后的结果仍可复现
+        w.shareBound = nodeBudget <= 0;
+        w.reset(prefix, level);
+
+        if (level < depth) {
+            if (w.shareBound && incumbent.dominates(w.score() + w.upperBound(level), key)) return;
+            QVector<Placement> opts;
+            w.options(level, opts);
+            const int shift = 16 * (3 - level);
+            // 逆序压栈：本线程 LIFO 先取到第一个方案，窃取者从队首拿走“跳过”等靠后的分支
+            for (int k = opts.size(); k >= 0; --k) {
+                QVector<Placement> childPrefix = prefix;
+                if (k < opts.size()) childPrefix.append(opts[k]);   // 最后一个分支表示跳过
+                const quint64 childKey = key | (quint64(k) << shift);
+                pool.spawn(worker, [&expand, childPrefix, level, childKey](int wk) {
+                    expand(wk, childPrefix, level + 1, childKey);
+                });
+            }
+            return;
+        }
+
+        w.best.score = -1;      // 子树根本身也是一个候选方案
+        w.dfs(level);
+        totalNodes += w.nodes;
+        if (w.aborted) incomplete = true;
+    };
+
+    pool.submit([&expand](int wk) { expand(wk, {}, 0, 0); });
+    pool.waitForDone();
+
+    if (incumbent.found && incumbent.solution.score > 0)
+        out = incumbent.solution;
+    out.nodes = totalNodes.load();
+    out.optimal = !incomplete.load();
+    return true;
+}
+
+namespace {
+
+// 局部搜索的可变状态：在 SolverState 之上维护已排 / 未排的候选课程表，便于 O(1) 随机取样；
+// 另按学期记录每个节次位上的已排课程，挤出时只看新班次占用的节次，不扫描全部已排课程
+class LocalSearch {
+public:
+    LocalSearch(const ScheduleProblem& p, const ScheduleSolution& start, quint32 seed);
+
+    // 尝试一次随机移动，被接受时返回 true
+    bool step(double temperature);
+    qint64 score() const { return st.score; }
+    int credits() const { return st.totalCredit; }
+    int unplacedCount() const { return unplaced.size(); }
+    double meanValue() const;
+    QVector<Placement> placements() const;
+
+    qint64 moves = 0;
+
+private:
+    static constexpr int TabuTenure = 64;   // 被挤出的课程在这么多步内不再插回
+
+    bool relocate();
+    bool swapSemesters();
+    bool insert();
+    bool replace(double temperature);
+    bool accept(qint64 delta, double temperature);
+
+    int latestSemester(int course) const;
+    bool hasPlacedDependent(int course) const;
+    bool placeAnyOffering(int course, int semester);
+    Placement placementOf(int course) const {
+        return Placement{course, st.placedOffering[course], st.placedSemester[course]};
+    }
+    void markPlaced(int course) { transfer(unplaced, placed, course); }
+    void markUnplaced(int course) { transfer(placed, unplaced, course); }
+    void transfer(QVector<int>& from, QVector<int>& to, int course);
+    // 移动成立后登记 / 注销已排班次：只更新节次占用表与学期课程表。
+    // 试探时只改 st，失败的移动不必回滚这两张表
+    void claim(const Placement& pl);
+    void release(const Placement& pl);
+
+    static constexpr int SlotBits = 128;   // 与 WeekOccupancy::weeks 一致
+
+    const ScheduleProblem& p;
+    const CourseCatalog& cat;
+    SolverState st;
+    QRandomGenerator rng;
+    qint64 creditCap;
+    QVector<int> placed;          // 已排的候选课程
+    QVector<int> unplaced;        // 未排的候选课程
+    QVector<int> slot;            // 课程下标 -> 在 placed 或 unplaced 中的位置
+    QVector<qint64> tabuUntil;    // 课程下标 -> 第几步之前不再插入
+    // 学期 * SlotBits + 节次位 -> 占用该节次的已排课程。同一节次上各课程的周互不相交，
+    // 通常只有一门
+    QVector<QVector<int>> owners;
+    QVector<QVector<int>> semesterCourses;   // 学期 -> 已排课程
+    QVector<int> semesterSlot;               // 课程下标 -> 在 semesterCourses 中的位置
+};
+
+LocalSearch::LocalSearch(const ScheduleProblem& p, const ScheduleSolution& start, quint32 seed)
+    : p(p), cat(*p.catalog), st(p), rng(seed),
+    slot(p.catalog->courseCount(), -1),
+    tabuUntil(p.catalog->courseCount(), 0),
+    owners(p.semesterCount() * SlotBits),
+    semesterCourses(p.semesterCount()),
+    semesterSlot(p.catalog->courseCount(), -1)
+{
+    for (int c : p.order) {
+        if (!p.isCandidate(c) || p.tooDeep(c) || cat.offeringBegin(c) == cat.offeringEnd(c)) continue;
+        slot[c] = unplaced.size();
+        unplaced.append(c);
+    }
+    for (const auto& pl : start.placements) {
+        st.place(pl);
+        claim(pl);
+        markPlaced(pl.course);
+    }
+    creditCap = p.creditCap > 0 ? qMax<qint64>(p.creditCap, st.totalCredit)
+                                : std::numeric_limits<qint64>::max();
+}
+
+void LocalSearch::transfer(QVector<int>& from, QVector<int>& to, int course) {
+    const int i = slot[course];
+    from[i] = from.last();
+    slot[from[i]] = i;
+    from.removeLast();
+    slot[course] = to.size();
+    to.append(course);
+}
+
+void LocalSearch::claim(const Placement& pl) {
+    QVector<int>* row = owners.data() + pl.semester * SlotBits;
+    cat.offeringMask(pl.offering).anyBit([row, &pl](int b) {
+        row[b].append(pl.course);
+        return false;
+    });
+    semesterSlot[pl.course] = semesterCourses[pl.semester].size();
+    semesterCourses[pl.semester].append(pl.course);
+}
+
+void LocalSearch::release(const Placement& pl) {
+    QVector<int>* row = owners.data() + pl.semester * SlotBits;
+    cat.offeringMask(pl.offering).anyBit([row, &pl](int b) {
+        row[b].removeOne(pl.course);
+        return false;
+    });
+    QVector<int>& list = semesterCourses[pl.semester];
+    const int i = semesterSlot[pl.course];
+    list[i] = list.last();
+    semesterSlot[list[i]] = i;
+    list.removeLast();
+    semesterSlot[pl.course] = -1;
+}
+
+double LocalSearch::meanValue() const {
+    qint64 sum = 0;
+    for (int c : placed) sum += p.value(c);
+    for (int c : unplaced) sum += p.value(c);
+    const int n = placed.size() + unplaced.size();
+    return n == 0 ? 1.0 : qMax(1.0, double(sum) / n);
+}
+
+QVector<Placement> LocalSearch::placements() const {
+    QVector<Placement> out;
+    out.reserve(placed.size());
+    for (int c : placed) out.append(placementOf(c));
+    // 按学期排列，先修课总在依赖它的课程之前
+    std::sort(out.begin(), out.end(), [](const Placement& a, const Placement& b) {
+        return a.semester != b.semester ? a.semester < b.semester : a.course < b.course;
+    });
+    return out;
+}
+
+// 已排课程所能移到的最晚学期：早于所有已排的直接后续课程
+int LocalSearch::latestSemester(int course) const {
+    int latest = p.semesterCount() - 1;
+    for (int d : p.graph->dependents(course)) {
+        const int s = st.placedSemester[d];
+        if (s >= 0) latest = qMin(latest, s - 1);
+    }
+    return latest;
+}
+
+bool LocalSearch::hasPlacedDependent(int course) const {
+    for (int d : p.graph->dependents(course)) {
+        if (st.placedSemester[d] >= 0) return true;
+    }
+    return false;
+}
+
+// 从随机班次开始找第一个放得下的班次并放入（只改 st，不动候选表）
+bool LocalSearch::placeAnyOffering(int course, int semester) {
+    const int begin = cat.offeringBegin(course);
+    const int n = cat.offeringEnd(course) - begin;
+    const int k = rng.bounded(n);
+    for (int i = 0; i < n; ++i) {
+        const int o = begin + (k + i) % n;
+        if (st.canPlace(course, o, semester)) {
+            st.place(Placement{course, o, semester});
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LocalSearch::accept(qint64 delta, double temperature) {
+    if (delta >= 0) return true;
+    if (temperature <= 0) return false;
+    return rng.generateDouble() < std::exp(double(delta) / temperature);
+}
+
+// 换学期 / 换班次：得分不变，为后续插入腾出位置
+bool LocalSearch::relocate() {
+    if (placed.isEmpty()) return false;
+    const int c = placed[rng.bounded(int(placed.size()))];
+    const int lo = st.earliestSemester(c);
+    const int hi = latestSemester(c);
+    if (lo < 0 || lo > hi) return false;
+    const int s = lo + rng.bounded(hi - lo + 1);
+    const int o = cat.offeringBegin(c) + rng.bounded(cat.offeringEnd(c) - cat.offeringBegin(c));
+    const Placement old = placementOf(c);
+    if (old.semester == s && old.offering == o) return false;
+    st.unplace(old);
+    if (st.canPlace(c, o, s)) {
+        st.place(Placement{c, o, s});
+        release(old);
+        claim(placementOf(c));
+        return true;
+    }
+    st.place(old);
+    return false;
+}
+
+// 交换两门已排课程的学期，各自在新学期任选一个放得下的班次
+bool LocalSearch::swapSemesters() {
+    if (placed.size() < 2) return false;
+    const int a = placed[rng.bounded(int(placed.size()))];
+    const int b = placed[rng.bounded(int(placed.size()))];
+    const Placement pa = placementOf(a), pb = placementOf(b);
+    if (pa.semester == pb.semester) return false;
+    // 互为直接先修时窗口自然排除交换
+    if (pb.semester < st.earliestSemester(a) || pb.semester > latestSemester(a) ||
+        pa.semester < st.earliestSemester(b) || pa.semester > latestSemester(b))
+        return false;
+    st.unplace(pa);
+    st.unplace(pb);
+    if (placeAnyOffering(a, pb.semester)) {
+        if (placeAnyOffering(b, pa.semester)) {
+            release(pa);
+            release(pb);
+            claim(placementOf(a));
+            claim(placementOf(b));
+            return true;
+        }
+        st.unplace(placementOf(a));
+    }
+    st.place(pa);
+    st.place(pb);
+    return false;
+}
+
+// 插入一门未排课程：从随机学期开始找第一个可行的 (学期, 班次)
+bool LocalSearch::insert() {
+    if (unplaced.isEmpty()) return false;
+    const int u = unplaced[rng.bounded(int(unplaced.size()))];
+    if (tabuUntil[u] > moves) return false;
+    if (st.totalCredit + cat.credit(u) > creditCap) return false;
+    const int lo = st.earliestSemester(u);
+    if (lo < 0 || lo >= p.semesterCount()) return false;
+    const int span = p.semesterCount() - lo;
+    const int k = rng.bounded(span);
+    for (int i = 0; i < span; ++i) {
+        if (placeAnyOffering(u, lo + (k + i) % span)) {
+            claim(placementOf(u));
+            markPlaced(u);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 挤出：把未排课程 u 放进随机的 (学期, 班次)，移出与之时间冲突的已排课程（至多两门），
+// 学分仍超限时再移出该学期的一门课程；被移出的课程不能有已排的后续课程
+bool LocalSearch::replace(double temperature) {
+    if (unplaced.isEmpty()) return false;
+    const int u = unplaced[rng.bounded(int(unplaced.size()))];
+    if (tabuUntil[u] > moves) return false;
+    const int lo = st.earliestSemester(u);
+    if (lo < 0 || lo >= p.semesterCount()) return false;
+    const int s = lo + rng.bounded(p.semesterCount() - lo);
+    const int o = cat.offeringBegin(u) + rng.bounded(cat.offeringEnd(u) - cat.offeringBegin(u));
+    if (cat.offeringMask(o).intersects(p.blocked[s])) return false;
+
+    // 冲突课程只可能占着 o 的节次：沿 o 的置位节次查占用表，再比较周
+    QVector<int> victims;
+    int freed = 0;
+    const quint32 weeks = cat.offeringWeeks(o);
+    const QVector<int>* row = owners.constData() + s * SlotBits;
+    const bool tooMany = cat.offeringMask(o).anyBit([&](int b) {
+        for (int c : row[b]) {
+            if ((cat.offeringWeeks(st.placedOffering[c]) & weeks) == 0 || victims.contains(c)) continue;
+            if (victims.size() == 2 || hasPlacedDependent(c)) return true;
+            victims.append(c);
+            freed += cat.credit(c);
+        }
+        return false;
+    });
+    if (tooMany) return false;
+    if (st.semCredit[s] - freed + cat.credit(u) > p.creditLimits[s]) {
+        // 学分仍超限：从该学期随机挑一门可移出的课程
+        const QVector<int>& inSemester = semesterCourses[s];
+        if (inSemester.isEmpty()) return false;
+        const int start = rng.bounded(int(inSemester.size()));
+        for (int i = 0; i < inSemester.size(); ++i) {
+            const int c = inSemester[(start + i) % inSemester.size()];
+            if (victims.contains(c) || hasPlacedDependent(c)) continue;
+            victims.append(c);
+            freed += cat.credit(c);
+            break;
+        }
+        if (st.semCredit[s] - freed + cat.credit(u) > p.creditLimits[s]) return false;
+    }
+    if (st.totalCredit - freed + cat.credit(u) > creditCap) return false;
+
+    qint64 delta = p.value(u);
+    for (int c : victims) delta -= p.value(c);
+    if (!accept(delta, temperature)) return false;
+
+    QVector<Placement> removed;
+    for (int c : victims) {
+        removed.append(placementOf(c));
+        st.unplace(removed.last());
+    }
+    if (!st.canPlace(u, o, s)) {
+        for (const auto& pl : removed) st.place(pl);
+        return false;
+    }
+    st.place(Placement{u, o, s});
+    for (const auto& pl : removed) release(pl);
+    claim(Placement{u, o, s});
+    markPlaced(u);
+    for (int c : victims) {
+        markUnplaced(c);
+        tabuUntil[c] = moves + TabuTenure;
+    }
+    return true;
+}
+
+bool LocalSearch::step(double temperature) {
+    ++moves;
+    const int r = rng.bounded(100);
+    if (r < 30) return insert();
+    if (r < 60) return replace(temperature);
+    if (r < 85) return relocate();
+    return swapSemesters();
+}
+
+} // namespace
+
+bool LocalSearchSolver::solve(const ScheduleProblem& p, ScheduleSolution& out) {
+    curve.clear();
+    QElapsedTimer timer;
+    timer.start();
+
+    // 起点为贪心方案；贪心很快，不单独报告进度
+    ScheduleProblem greedyInput = p;
+    greedyInput.monitor = nullptr;
+    ScheduleSolution start;
+    GreedySolver greedy;
+    if (!greedy.solve(greedyInput, start)) return false;
+
+    LocalSearch ls(p, start, seed);
+    out = start;
+    curve.append(ImprovementPoint{timer.elapsed(), out.score, 0});
+    if (p.monitor && out.score > 0) p.monitor->improved(out);
+
+    // 初温取候选课程的平均价值：开始时常接受挤出一门同等价值课程，临近预算时几乎只接受改进
+    const double t0 = ls.meanValue();
+    double temperature = t0;
+    while (ls.unplacedCount() > 0) {
+        if (moveBudget > 0 && ls.moves >= moveBudget) break;
+        if ((ls.moves & 255) == 0) {
+            const qint64 ms = timer.elapsed();
+            if (ms >= budgetMs) break;
+            const double elapsed = moveBudget > 0 ? double(ls.moves) / double(moveBudget)
+                                                  : double(ms) / qMax(1, budgetMs);
+            if (p.monitor) {
+                if (p.monitor->isCanceled()) break;
+                p.monitor->progress(int(elapsed * 100));
+            }
+            temperature = t0 * std::pow(0.001, elapsed);
+        }
+        ls.step(temperature);
+        if (ls.score() > out.score) {
+            out.placements = ls.placements();
+            out.score = ls.score();
+            out.credits = ls.credits();
+            curve.append(ImprovementPoint{timer.elapsed(), out.score, ls.moves});
+            if (p.monitor) p.monitor->improved(out);
+        }
+    }
+    out.nodes = ls.moves;
+    // 全部候选课程都已排入时不可能更好
+    out.optimal = ls.unplacedCount() == 0;
+    return true;
+}
+
+namespace {
+
+// 枚举器中的一个子空间：前 level 个决策固定（prefix 为其中排入的课程），
+// 第 level 个决策不能取 banned 中的选择，之后的决策不受限
+struct Subspace {
+    QVector<Placement> prefix;
+    int level = 0;
+    QVector<Placement> banned;   // offering 为 -1 表示不允许“跳过”
+    qint64 key = 0;              // 已求解时为子空间最优方案的得分，否则为其上界
+    bool solved = false;
+    ScheduleSolution best;       // solved 时有效，score 为 -1 表示子空间中没有可接受的方案
+    int checked = 0;             // 求解时已避开的方案数（results 的前缀）
+    quint64 seq = 0;             // 入队次序
+
+    // 优先队列中“更小”者后出队：键大者先出；同键时已求解的先出，可以直接给出；再按入队次序
+    bool operator<(const Subspace& o) const {
+        if (key != o.key) return key < o.key;
+        if (solved != o.solved) return !solved;
+        return seq > o.seq;
+    }
+};
+
+} // namespace
+
+struct ScheduleEnumerator::State {
+    State(const ScheduleProblem& p, int dist)
+        : problem(p), model(problem, 0), minDistance(dist) {}
+
+    bool solve(Subspace& s);
+    void partition(const Subspace& s);
+    void push(Subspace s) {
+        s.seq = nextSeq++;
+        queue.push(std::move(s));
+    }
+    // best 是否仍与求解之后新给出的方案保持差异
+    bool stillDiverse(const Subspace& s) const;
+
+    ScheduleProblem problem;     // model 引用它；next() 时更新其中的 monitor
+    SearchModel model;
+    int minDistance;
+    int budgetMs = 2000;
+    std::priority_queue<Subspace> queue;
+    quint64 nextSeq = 0;
+    QVector<ScheduleSolution> results;
+};
+
+bool ScheduleEnumerator::State::solve(Subspace& s) {
+    SearchWorker w(model);
+    QElapsedTimer timer;
+    timer.start();
+    w.timer = &timer;
+    w.budgetMs = budgetMs;
+    w.reportImproved = false;
+    w.avoid = &results;
+    w.minDistance = minDistance;
+    w.reset(s.prefix, s.level);
+    w.best.score = -1;
+    w.dfsExcluding(s.level, s.banned);
+    if (problem.monitor && problem.monitor->isCanceled()) return false;
+
+    s.best = w.best;
+    s.best.optimal = !w.aborted;
+    s.best.nodes = w.nodes;
+    s.key = s.best.score;
+    s.solved = true;
+    s.checked = results.size();
+    return true;
+}
+
+bool ScheduleEnumerator::State::stillDiverse(const Subspace& s) const {
+    if (minDistance <= 0) return true;
+    for (int i = s.checked; i < results.size(); ++i) {
+        if (distance(s.best.placements, results[i].placements) < minDistance) return false;
+    }
+    return true;
+}
+
+// s 的最优方案 x 已给出：把 s 拆成 “第 level 个决策不同于 x” 以及对每个 j > level
+// “level..j-1 与 x 相同、第 j 个决策不同于 x” 这些子空间，它们恰好覆盖 s 中除 x 以外的全部方案
+void ScheduleEnumerator::State::partition(const Subspace& s) {
+    const int n = model.items.size();
+    QVector<Placement> choice(n - s.level);
+    for (int j = s.level; j < n; ++j)
+        choice[j - s.level] = Placement{model.items[j].course, -1, -1};
+    for (const auto& pl : s.best.placements) {
+        const int j = model.itemOf[pl.course];
+        if (j >= s.level) choice[j - s.level] = pl;
+    }
+
+    SearchWorker w(model);
+    w.reset(s.prefix, s.level);
+    QVector<Placement> prefix = s.prefix;
+    QVector<Placement> opts;
+    for (int j = s.level; j < n; ++j) {
+        const Placement& x = choice[j - s.level];
+        Subspace child;
+        child.level = j;
+        child.banned = j == s.level ? s.banned : QVector<Placement>();
+        child.banned.append(x);
+
+        // 第 j 个决策已无其他选择的子空间直接丢弃
+        bool open = false;
+        auto allowed = [&child](int offering, int semester) {
+            for (const auto& b : child.banned) {
+                if (b.offering == offering && b.semester == semester) return false;
+            }
+            return true;
+        };
+        if (allowed(-1, -1)) {
+            open = true;
+        } else {
+            w.options(j, opts);
+            for (const auto& pl : opts) {
+                if (allowed(pl.offering, pl.semester)) { open = true; break; }
+            }
+        }
+        if (open) {
+            child.prefix = prefix;
+            child.key = qMin(s.best.score, w.score() + w.upperBound(j));
+            push(std::move(child));
+        }
+
+        if (x.offering >= 0) {
+            prefix.append(x);
+            w.reset(prefix, j + 1);
+        }
+    }
+}
+
+ScheduleEnumerator::ScheduleEnumerator(const ScheduleProblem& problem, int minDistance)
+    : d(new State(problem, minDistance))
+{
+    d->problem.monitor = nullptr;
+    Subspace root;
+    root.key = d->model.suffixValue[0];
+    d->push(std::move(root));
+}
+
+ScheduleEnumerator::~ScheduleEnumerator() = default;
+
+void ScheduleEnumerator::setTimeBudget(int ms) {
+    d->budgetMs = ms;
+}
+
+int ScheduleEnumerator::minDistance() const {
+    return d->minDistance;
+}
+
+const QVector<ScheduleSolution>& ScheduleEnumerator::results() const {
+    return d->results;
+}
+
+bool ScheduleEnumerator::next(ScheduleSolution& out, SolveMonitor* monitor) {
+    d->problem.monitor = monitor;
+    while (!d->queue.empty()) {
+        Subspace s = d->queue.top();
+        d->queue.pop();
+        if (!s.solved) {
+            if (!d->solve(s)) {
+                d->push(std::move(s));   // 被取消：原样放回，下次继续
+                return false;
+            }
+            if (s.best.score >= 0) d->push(std::move(s));
+            continue;
+        }
+        // 求解之后又给出了新方案：不再满足差异约束时以原得分为上界重新求解
+        if (!d->stillDiverse(s)) {
+            s.solved = false;
+            d->push(std::move(s));
+            continue;
+        }
+        out = s.best;
+        d->results.append(out);
+        d->partition(s);
+        return true;
+    }
+    return false;
+}
+
+int ScheduleEnumerator::distance(const QVector<Placement>& a, const QVector<Placement>& b) {
+    QHash<int, Placement> byCourse;
+    byCourse.reserve(a.size());
+    for (const auto& pl : a) byCourse.insert(pl.course, pl);
+    int dist = a.size() + b.size();
+    for (const auto& pl : b) {
+        auto it = byCourse.constFind(pl.course);
+        if (it == byCourse.constEnd()) continue;
+        const Placement& x = it.value();
+        dist -= x.semester == pl.semester && x.offering == pl.offering ? 2 : 1;
+    }
+    return dist;
+}
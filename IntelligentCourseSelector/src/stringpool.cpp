@@ -0,0 +1,83 @@
+#include "stringpool.h"
+#include <algorithm>
+
+namespace {
+
+// 严格的 UTF-8 -> UTF-16 解码；遇到非法序列返回 false，由调用方交给 QString::fromUtf8
+// 处理，保证替换字符等边界行为与 Qt 一致
+bool decodeUtf8(const char* data, qsizetype size, std::vector<QChar>& out) {
+    out.clear();
+    const auto* p = reinterpret_cast<const unsigned char*>(data);
+    const auto* end = p + size;
+    while (p < end) {
+        const unsigned char b = *p;
+        if (b < 0x80) {
+            out.push_back(QChar(char16_t(b)));
+            ++p;
+            continue;
+        }
+        int extra;
+        char32_t cp;
+        char32_t min;
+        if ((b & 0xE0) == 0xC0) { extra = 1; cp = b & 0x1F; min = 0x80; }
+        else if ((b & 0xF0) == 0xE0) { extra = 2; cp = b & 0x0F; min = 0x800; }
+        else if ((b & 0xF8) == 0xF0) { extra = 3; cp = b & 0x07; min = 0x10000; }
+        else return false;
+        if (end - p <= extra) return false;
+        for (int k = 1; k <= extra; ++k) {
+            if ((p[k] & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (p[k] & 0x3F);
+        }
+        if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return false;
+        if (cp >= 0x10000) {
+            cp -= 0x10000;
+            out.push_back(QChar(char16_t(0xD800 + (cp >> 10))));
+            out.push_back(QChar(char16_t(0xDC00 + (cp & 0x3FF))));
+        } else {
+            out.push_back(QChar(char16_t(cp)));
+        }
+        p += extra + 1;
+    }
+    return true;
+}
+
+} // namespace
+
+QChar* StringPool::allocate(qsizetype n) {
+    blocks.emplace_back(new QChar[n]);
+    allocatedChars += n;
+    return blocks.back().get();
+}
+
+const QChar* StringPool::store(QStringView s) {
+    QChar* p;
+    if (s.size() > BlockChars / 2) {
+        // 长字符串单独成块，当前块的剩余空间留给后面的短字符串
+        p = allocate(s.size());
+    } else {
+        if (!block || used + s.size() > BlockChars) {
+            block = allocate(BlockChars);
+            used = 0;
+        }
+        p = block + used;
+        used += s.size();
+    }
+    std::copy(s.data(), s.data() + s.size(), p);
+    return p;
+}
+
+QString StringPool::intern(QStringView s) {
+    ++lookupCount;
+    if (s.isEmpty()) return QString();
+    auto it = index.constFind(s);
+    if (it != index.constEnd()) return QString::fromRawData(it->data(), it->size());
+    const QChar* p = store(s);
+    index.insert(QStringView(p, s.size()));
+    return QString::fromRawData(p, s.size());
+}
+
+QString StringPool::internUtf8(const char* data, qsizetype size) {
+    if (!decodeUtf8(data, size, scratch))
+        return intern(QString::fromUtf8(data, size));
+    return intern(QStringView(scratch.data(), qsizetype(scratch.size())));
+}
@@ -0,0 +1,166 @@
+#include "timetableview.h"
+#include <QEvent>
+#include <QHelpEvent>
+#include <QPainter>
+#include <QToolTip>
+#include <cstring>
+
+namespace {
+const char* const DayNames[7] = {"周一", "周二", "周三", "周四", "周五", "周六", "周日"};
+const QColor CompulsoryColor(173, 216, 230);
+const QColor ElectiveColor(255, 255, 224);
+const QColor BlockedColor(225, 225, 225);
+}
+
+TimetableView::TimetableView(QWidget* parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+void TimetableView::setCatalog(const CourseCatalog* cat) {
+    catalog = cat;
+    placements.clear();
+    entries.clear();
+    for (auto& cell : cells) cell.clear();
+    update();
+}
+
+bool TimetableView::setContents(const QVector<Placement>& pls, const SlotMask& blk) {
+    if (pls == placements && std::memcmp(blk.day, blocked.day, sizeof(blk.day)) == 0)
+        return false;
+    placements = pls;
+    blocked = blk;
+
+    // 只在内容变化时重建单元格索引；课程名一并缓存，绘制时不再访问目录
+    entries.clear();
+    for (auto& cell : cells) cell.clear();
+    if (catalog) {
+        for (const auto& pl : placements) {
+            const int e = entries.size();
+            entries.append(Entry{pl, catalog->courseName(pl.course), catalog->isCompulsory(pl.course)});
+            const SlotMask& m = catalog->offeringMask(pl.offering);
+            for (int d = 0; d < Days; ++d) {
+                for (int s = 0; s < Slots; ++s) {
+                    if (m.day[d] & (1u << s)) cells[d * Slots + s].append(e);
+                }
+            }
+        }
+    }
+    update();
+    return true;
+}
+
+QSize TimetableView::sizeHint() const {
+    return QSize(80 * Days + 60, 28 * (Slots + 1));
+}
+
+QSize TimetableView::minimumSizeHint() const {
+    return QSize(40 * Days + 50, 18 * (Slots + 1));
+}
+
+// 左侧留出时间列，上方留出星期行
+QRect TimetableView::gridRect() const {
+    const QFontMetrics fm = fontMetrics();
+    const int left = fm.horizontalAdvance("00:00") + 12;
+    const int top = fm.height() + 8;
+    return rect().adjusted(left, top, -1, -1);
+}
+
+QRect TimetableView::cellRect(int day, int slot) const {
+    const QRect g = gridRect();
+    const int x0 = g.left() + g.width() * day / Days;
+    const int x1 = g.left() + g.width() * (day + 1) / Days;
+    const int y0 = g.top() + g.height() * slot / Slots;
+    const int y1 = g.top() + g.height() * (slot + 1) / Slots;
+    return QRect(x0, y0, x1 - x0, y1 - y0);
+}
+
+bool TimetableView::cellAt(const QPoint& pos, int& day, int& slot) const {
+    const QRect g = gridRect();
+    if (!g.contains(pos) || g.width() <= 0 || g.height() <= 0) return false;
+    day = qMin(Days - 1, (pos.x() - g.left()) * Days / g.width());
+    slot = qMin(Slots - 1, (pos.y() - g.top()) * Slots / g.height());
+    return true;
+}
+
+void TimetableView::paintEvent(QPaintEvent*) {
+    QPainter p(this);
+    p.fillRect(rect(), palette().base());
+    const QRect g = gridRect();
+    const QColor gridColor = palette().mid().color();
+
+    p.setPen(palette().text().color());
+    for (int d = 0; d < Days; ++d) {
+        const QRect c = cellRect(d, 0);
+        p.drawText(QRect(c.left(), 0, c.width(), g.top()), Qt::AlignCenter, DayNames[d]);
+    }
+    for (int s = 0; s < Slots; ++s) {
+        const int m = 8 * 60 + s * 45;
+        const QRect c = cellRect(0, s);
+        p.drawText(QRect(0, c.top(), g.left() - 4, c.height()), Qt::AlignRight | Qt::AlignVCenter,
+                   QString("%1:%2").arg(m / 60).arg(m % 60, 2, 10, QChar('0')));
+    }
+
+    for (int d = 0; d < Days; ++d) {
+        for (int s = 0; s < Slots; ++s) {
+            const QRect c = cellRect(d, s);
+            const QVector<int>& here = cells[d * Slots + s];
+            if (here.isEmpty()) {
+                if (blocked.day[d] & (1u << s)) p.fillRect(c, BlockedColor);
+                continue;
+            }
+            // 共用单元格的班次左右平分
+            for (int i = 0; i < here.size(); ++i) {
+                const Entry& e = entries[here[i]];
+                const QRect part(c.left() + c.width() * i / here.size(), c.top(),
+                                 c.width() / here.size(), c.height());
+                p.fillRect(part, e.compulsory ? CompulsoryColor : ElectiveColor);
+                p.setPen(palette().text().color());
+                p.drawText(part.adjusted(3, 0, -3, 0), Qt::AlignCenter,
+                           p.fontMetrics().elidedText(e.name, Qt::ElideRight, part.width() - 6));
+            }
+        }
+    }
+
+    p.setPen(gridColor);
+    for (int d = 0; d <= Days; ++d) {
+        const int x = d == Days ? g.right() : cellRect(d, 0).left();
+        p.drawLine(x, g.top(), x, g.bottom());
+    }
+    for (int s = 0; s <= Slots; ++s) {
+        const int y = s == Slots ? g.bottom() : cellRect(0, s).top();
+        p.drawLine(g.left(), y, g.right(), y);
+    }
+}
+
+bool TimetableView::event(QEvent* ev) {
+    if (ev->type() == QEvent::ToolTip) {
+        auto* help = static_cast<QHelpEvent*>(ev);
+        int day = 0, slot = 0;
+        const QString tip = cellAt(help->pos(), day, slot) ? toolTipFor(day, slot) : QString();
+        if (tip.isEmpty()) {
+            QToolTip::hideText();
+            ev->ignore();
+        } else {
+            QToolTip::showText(help->globalPos(), tip, this, cellRect(day, slot));
+        }
+        return true;
+    }
+    return QWidget::event(ev);
+}
+
+QString TimetableView::toolTipFor(int day, int slot) const {
+    QStringList parts;
+    for (int e : cells[day * Slots + slot]) {
+        const Entry& entry = entries[e];
+        const CourseOffering off = catalog->offering(entry.placement.offering);
+        parts.append(QString("%1\n教师:%2\n学分:%3\n时间:%4\n周次:%5")
+                         .arg(entry.name).arg(off.teacher).arg(catalog->credit(entry.placement.course))
+                         .arg(off.timeSlotsToString()).arg(off.weeksToString()));
+    }
+    if (parts.isEmpty() && (blocked.day[day] & (1u << slot)))
+        return "屏蔽时间";
+    return parts.join("\n\n");
+}
@@ -0,0 +1,90 @@
+#include "workstealingpool.h"
+#include <QtGlobal>
+
+WorkStealingPool::WorkStealingPool(int threads) {
+    if (threads <= 0)
+        threads = qMax(1u, std::thread::hardware_concurrency());
+    workers.reserve(threads);
+    for (int i = 0; i < threads; ++i)
+        workers.emplace_back(new Worker);
+    for (int i = 0; i < threads; ++i)
+        workers[i]->thread = std::thread([this, i]{ run(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    waitForDone();
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& w : workers)
+        w->thread.join();
+}
+
+void WorkStealingPool::submit(Task task) {
+    push(int(nextWorker++ % workers.size()), std::move(task));
+}
+
+void WorkStealingPool::spawn(int worker, Task task) {
+    push(worker, std::move(task));
+}
+
+void WorkStealingPool::push(int worker, Task task) {
+    ++pending;
+    {
+        std::lock_guard<std::mutex> lock(workers[worker]->mutex);
+        workers[worker]->tasks.push_back(std::move(task));
+    }
+    // 先拿一次 idleMutex，避免与正在进入等待的线程错过通知
+    { std::lock_guard<std::mutex> lock(idleMutex); }
+    wake.notify_one();
+}
+
+bool WorkStealingPool::pop(int worker, Task& task) {
+    Worker& w = *workers[worker];
+    std::lock_guard<std::mutex> lock(w.mutex);
+    if (w.tasks.empty()) return false;
+    task = std::move(w.tasks.back());
+    w.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(int thief, Task& task) {
+    const int n = int(workers.size());
+    for (int k = 1; k < n; ++k) {
+        Worker& w = *workers[(thief + k) % n];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (w.tasks.empty()) continue;
+        task = std::move(w.tasks.front());
+        w.tasks.pop_front();
+        ++steals;
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::run(int worker) {
+    for (;;) {
+        Task task;
+        if (pop(worker, task) || steal(worker, task)) {
+            task(worker);
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                done.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMutex);
+        if (stopping) return;
+        // 带超时等待：新任务可能由其他线程派生到它们自己的队列里
+        wake.wait_for(lock, std::chrono::milliseconds(2));
+        if (stopping) return;
+    }
+}
+
+void WorkStealingPool::waitForDone() {
+    std::unique_lock<std::mutex> lock(idleMutex);
+    done.wait(lock, [this]{ return pending.load() == 0; });
+}
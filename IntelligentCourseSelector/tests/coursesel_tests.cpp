@@ -0,0 +1,874 @@
+// coursesel_tests.cpp
+// 核心库的单元测试（QtTest，只依赖 Qt Core）：每项优化都与一个直接、低效但显然正确的
+// 实现对照——分支定界与穷举、流式解析（含字符串池）与 DOM / 二进制目录、列式目录与原课程、
+// 增量排课与整体重排、节次倒排位图与逐个冲突检测、先修闭包与图遍历、Top-K 枚举与穷举排序、
+// 备选方案与当前方案、局部搜索与贪心起点、课程检索与逐门子串判断、方案校验器的各类错误。
+// 夹具为代码中构造的小目录，或以 data/course.json 为样本合成的目录
+#include <QtTest>
+#include <QBitArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+#include "binarycatalog.h"
+#include "catalogsynth.h"
+#include "coursesearchindex.h"
+#include "jsonparser.h"
+#include "prereqclosure.h"
+#include "schedule.h"
+#include "schedulevalidator.h"
+#include "slotindex.h"
+#include "solver.h"
+#include "stringpool.h"
+
+namespace {
+
+using PlanKey = std::vector<std::tuple<int, int, int>>;   // 排好序的 (课程, 班次, 学期)
+
+// 求解器输入：目录、先修图与闭包按值持有，problem 指向它们
+struct Fixture {
+    CourseCatalog catalog;
+    PrereqGraph graph;
+    PrereqClosure closure;
+    ScheduleProblem problem;
+
+    Fixture(const QList<Course>& courses, int semesters, int creditLimit)
+        : catalog(courses), graph(catalog), closure(graph) {
+        const int n = catalog.courseCount();
+        problem.catalog = &catalog;
+        problem.graph = &graph;
+        problem.closure = &closure;
+        graph.sort(problem.order);
+        problem.priorities.fill(0, n);
+        problem.selected = QBitArray(n);
+        problem.creditLimits.fill(creditLimit, semesters);
+        problem.blocked.resize(semesters);
+    }
+    Fixture(const Fixture&) = delete;
+    Fixture& operator=(const Fixture&) = delete;
+
+    void select(int course, int priority) {
+        problem.selected.setBit(course);
+        problem.priorities[course] = priority;
+    }
+    // 随机选 k 门课程，约一半连同其直接先修课一起选中
+    void selectRandom(QRandomGenerator& rng, int k) {
+        const int n = catalog.courseCount();
+        for (int i = 0; i < k; ++i) {
+            const int c = rng.bounded(n);
+            select(c, 1 + rng.bounded(10));
+            if (rng.bounded(2) == 0) {
+                for (int p : graph.prerequisites(c)) select(p, 1 + rng.bounded(10));
+            }
+        }
+    }
+};
+
+PlanKey keyOf(const QVector<Placement>& placements) {
+    PlanKey k;
+    for (const auto& pl : placements) k.emplace_back(pl.course, pl.offering, pl.semester);
+    std::sort(k.begin(), k.end());
+    return k;
+}
+
+// 逐条检查方案：课程不重复、班次属于该课程、候选课程、时间不冲突且不落在屏蔽时间、
+// 先修课排在更早的学期、学期学分不超限、总学分不超过 creditCap、得分与学分合计正确。
+// 合法时返回空串。贪心（greedy）不看 creditCap，改为检查总学分达到 creditTarget 后
+// 只再排入手动选中的课程（placements 按排入顺序）
+QString violation(const ScheduleProblem& p, const ScheduleSolution& s, bool greedy = false) {
+    const CourseCatalog& cat = *p.catalog;
+    QVector<int> semester(cat.courseCount(), -1);
+    QVector<WeekOccupancy> occupancy(p.semesterCount());
+    QVector<int> credits(p.semesterCount(), 0);
+    qint64 score = 0;
+    int total = 0;
+    for (const auto& pl : s.placements) {
+        if (semester[pl.course] >= 0) return QString("课程 %1 重复").arg(pl.course);
+        if (greedy && !p.selected.testBit(pl.course) && total >= p.creditTarget)
+            return QString("总学分达到目标后仍排入未选中的课程 %1").arg(pl.course);
+        if (cat.offeringCourse(pl.offering) != pl.course) return QString("班次 %1 不属于课程 %2").arg(pl.offering).arg(pl.course);
+        if (!p.isCandidate(pl.course)) return QString("课程 %1 不是候选").arg(pl.course);
+        const SlotMask& mask = cat.offeringMask(pl.offering);
+        const quint32 weeks = cat.offeringWeeks(pl.offering);
+        if (occupancy[pl.semester].conflicts(mask, weeks) || mask.intersects(p.blocked[pl.semester]))
+            return QString("课程 %1 时间冲突").arg(pl.course);
+        occupancy[pl.semester].add(mask, weeks);
+        semester[pl.course] = pl.semester;
+        credits[pl.semester] += cat.credit(pl.course);
+        total += cat.credit(pl.course);
+        score += p.value(pl.course);
+    }
+    for (const auto& pl : s.placements) {
+        for (int pre : p.graph->prerequisites(pl.course)) {
+            if (semester[pre] < 0 || semester[pre] >= pl.semester)
+                return QString("课程 %1 的先修课 %2 未排在更早的学期").arg(pl.course).arg(pre);
+        }
+    }
+    for (int i = 0; i < p.semesterCount(); ++i) {
+        if (credits[i] > p.creditLimits[i]) return QString("第 %1 学期学分超限").arg(i);
+    }
+    if (!greedy && p.creditCap > 0 && total > p.creditCap)
+        return "总学分超限";
+    if (score != s.score || total != s.credits) return "得分或学分合计不符";
+    return QString();
+}
+
+// 穷举全部可行方案及其得分。时间与周次完全相同的班次互相等价，只取其中第一个
+class BruteForce {
+public:
+    explicit BruteForce(const ScheduleProblem& p) : p(p), st(p) {
+        for (int c : p.order) {
+            if (p.isCandidate(c)) candidates.append(c);
+        }
+        PlanKey current;
+        visit(0, current);
+    }
+
+    std::map<PlanKey, qint64> plans;
+
+    qint64 bestScore() const {
+        qint64 best = 0;
+        for (const auto& kv : plans) best = qMax(best, kv.second);
+        return best;
+    }
+
+private:
+    void visit(int i, PlanKey& current) {
+        if (i == candidates.size()) {
+            PlanKey k = current;
+            std::sort(k.begin(), k.end());
+            plans[k] = st.score;
+            return;
+        }
+        visit(i + 1, current);
+        const int c = candidates[i];
+        const CourseCatalog& cat = *p.catalog;
+        const int earliest = st.earliestSemester(c);
+        if (earliest < 0) return;
+        if (p.creditCap > 0 && st.totalCredit + cat.credit(c) > p.creditCap) return;
+        QVector<int> offerings;
+        for (int o = cat.offeringBegin(c); o < cat.offeringEnd(c); ++o) {
+            const bool same = std::any_of(offerings.begin(), offerings.end(), [&](int q) {
+                return cat.offeringWeeks(q) == cat.offeringWeeks(o) &&
+                       std::equal(std::begin(cat.offeringMask(q).day), std::end(cat.offeringMask(q).day),
+                                  std::begin(cat.offeringMask(o).day));
+            });
+            if (!same) offerings.append(o);
+        }
+        for (int s = earliest; s < p.semesterCount(); ++s) {
+            for (int o : offerings) {
+                if (!st.canPlace(c, o, s)) continue;
+                const Placement pl{c, o, s};
+                st.place(pl);
+                current.emplace_back(c, o, s);
+                visit(i + 1, current);
+                current.pop_back();
+                st.unplace(pl);
+            }
+        }
+    }
+
+    const ScheduleProblem& p;
+    SolverState st;
+    QVector<int> candidates;
+};
+
+// 课程逐字段比较，第一处不同的描述；相同时返回空串
+QString difference(const QList<Course>& a, const QList<Course>& b) {
+    if (a.size() != b.size()) return QString("课程数 %1 != %2").arg(a.size()).arg(b.size());
+    for (int i = 0; i < a.size(); ++i) {
+        const Course& x = a[i];
+        const Course& y = b[i];
+        if (x.id != y.id || x.name != y.name || x.credit != y.credit || x.required != y.required ||
+            x.prerequisites != y.prerequisites || x.offerings.size() != y.offerings.size())
+            return QString("课程 %1 不同").arg(x.id);
+        for (int k = 0; k < x.offerings.size(); ++k) {
+            const CourseOffering& u = x.offerings[k];
+            const CourseOffering& v = y.offerings[k];
+            if (u.id != v.id || u.teacher != v.teacher || u.weeks != v.weeks ||
+                !std::equal(std::begin(u.times), std::end(u.times), std::begin(v.times)))
+                return QString("课程 %1 的班次 %2 不同").arg(x.id, u.id);
+        }
+    }
+    return QString();
+}
+
+// 由目录各列物化出全部课程
+QList<Course> materialize(const CourseCatalog& catalog) {
+    QList<Course> out;
+    for (int c = 0; c < catalog.courseCount(); ++c) out.append(catalog.course(c));
+    return out;
+}
+
+Course makeCourse(const QString& id, int credit, int day, quint32 periods,
+                  const QStringList& prerequisites = {}) {
+    Course c;
+    c.id = id;
+    c.name = id;
+    c.credit = credit;
+    c.required = "Elective";
+    c.prerequisites = prerequisites;
+    CourseOffering o;
+    o.id = "01";
+    o.teacher = "T";
+    std::fill(std::begin(o.times), std::end(o.times), 0u);
+    o.times[day] = periods;
+    c.offerings.append(o);
+    return c;
+}
+
+// 课程 -> 学期，便于比较两份课表
+QMap<QString, int> semestersOf(const ScheduleManager& m) {
+    QMap<QString, int> out;
+    for (const auto& sc : m.getAllScheduled()) out.insert(sc.courseId, sc.semester);
+    return out;
+}
+
+} // namespace
+
+class CourseSelTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void branchAndBoundMatchesBruteForce();
+    void parsersAndBinaryCatalogRoundTrip();
+    void incrementalMatchesRegenerate();
+    void incrementalKeepsScheduleValid();
+    void freeOfferingsMatchConflicts();
+    void closureMatchesGraphWalk();
+    void enumeratorMatchesBruteForce();
+    void alternativesStartFromCurrentPlan();
+    void localSearchImprovesOnGreedy();
+    void searchIndexMatchesContains();
+    void validatorReportsErrors();
+
+private:
+    QList<Course> real;        // data/course.json
+    CatalogProfile profile;    // 合成目录的样本
+};
+
+void CourseSelTests::initTestCase() {
+    JsonParser parser;
+    real = parser.parseCourseJsonStream(QStringLiteral(COURSESEL_DATA_DIR "/course.json"));
+    QVERIFY(!real.isEmpty());
+    profile = CatalogProfile::fromCourses(real);
+}
+
+// 小规模问题上分支定界应完整结束并取得穷举最优，贪心不超过最优；所有方案都须合法
+void CourseSelTests::branchAndBoundMatchesBruteForce() {
+    for (quint32 seed = 1; seed <= 24; ++seed) {
+        QRandomGenerator rng(seed);
+        Fixture f(real, 2 + seed % 2, 6 + int(seed % 5));
+        f.selectRandom(rng, 5);
+        if (seed % 3 == 0) f.problem.creditCap = 10;
+        if (seed % 4 == 0) f.problem.creditTarget = 8;
+        const qint64 best = BruteForce(f.problem).bestScore();
+
+        ScheduleSolution greedy;
+        QVERIFY(GreedySolver().solve(f.problem, greedy));
+        QVERIFY2(violation(f.problem, greedy, true).isEmpty(), qPrintable(violation(f.problem, greedy, true)));
+        if (f.problem.creditCap == 0) QVERIFY(greedy.score <= best);   // 贪心不看总学分上限
+
+        ScheduleSolution bb;
+        QVERIFY(BranchBoundSolver(60000).solve(f.problem, bb));
+        QVERIFY2(violation(f.problem, bb).isEmpty(), qPrintable(violation(f.problem, bb)));
+        QVERIFY(bb.optimal);
+        QCOMPARE(bb.score, best);
+
+        ScheduleSolution parallel;
+        QVERIFY(ParallelBranchBoundSolver(2, 60000).solve(f.problem, parallel));
+        QVERIFY2(violation(f.problem, parallel).isEmpty(), qPrintable(violation(f.problem, parallel)));
+        QCOMPARE(parallel.score, best);
+    }
+}
+
+// 导出的 JSON 经 DOM、流式、带字符串池的流式解析都应还原出原课程；编译为 .cscat 后读回同样一致，
+// JSON 改动后二进制目录视为过期。列式目录（由课程列表或二进制目录构建）物化出的 Course 也应与原课程相同
+void CourseSelTests::parsersAndBinaryCatalogRoundTrip() {
+    QList<Course> courses = synthesizeCatalog(profile, 400, 11);
+    QRandomGenerator rng(5);
+    for (Course& c : courses) {
+        for (CourseOffering& o : c.offerings) {
+            const int r = rng.bounded(4);
+            o.weeks = r == 0 ? CourseOffering::AllWeeks : r == 1 ? 0x5555u : r == 2 ? 0u : rng.generate();
+        }
+    }
+    courses.append(real);   // 含中文名称与真实的先修关系
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString json = dir.filePath("course.json");
+    JsonParser parser;
+    QVERIFY(parser.exportCourseJson(courses, json));
+
+    const QList<Course> dom = parser.parseCourseJsonDom(json);
+    QVERIFY2(difference(courses, dom).isEmpty(), qPrintable(difference(courses, dom)));
+    const QList<Course> stream = parser.parseCourseJsonStream(json);
+    QVERIFY2(difference(courses, stream).isEmpty(), qPrintable(difference(courses, stream)));
+    {
+        StringPool pool;
+        const QList<Course> pooled = parser.parseCourseJsonStream(json, &pool);
+        QVERIFY2(difference(courses, pooled).isEmpty(), qPrintable(difference(courses, pooled)));
+        QVERIFY(pool.size() > 0);
+        QVERIFY(pool.size() < pool.lookups());
+    }
+    const QList<Course> columns = materialize(CourseCatalog(courses));
+    QVERIFY2(difference(courses, columns).isEmpty(), qPrintable(difference(courses, columns)));
+
+    const QString cscat = JsonParser::binaryCatalogPath(json);
+    QVERIFY(BinaryCatalog::write(courses, cscat, BinaryCatalog::sourceOf(json)));
+    BinaryCatalog binary;
+    QVERIFY2(binary.open(cscat), qPrintable(binary.errorString()));
+    const QList<Course> fromBinary = binary.toCourses();
+    QVERIFY2(difference(courses, fromBinary).isEmpty(), qPrintable(difference(courses, fromBinary)));
+    binary.close();
+    QVERIFY(binary.open(cscat, BinaryCatalog::FullCheck));
+    binary.close();
+
+    // 字符串表损坏只有全文件校验能发现；Header 损坏在打开时即被拒绝
+    const QString damaged = dir.filePath("damaged.cscat");
+    QVERIFY(QFile::copy(cscat, damaged));
+    auto flipByte = [&damaged](qint64 pos) {
+        QFile file(damaged);
+        if (!file.open(QIODevice::ReadWrite)) return false;
+        file.seek(pos);
+        char c = 0;
+        file.getChar(&c);
+        file.seek(pos);
+        return file.putChar(char(c ^ 0x5A));
+    };
+    QVERIFY(flipByte(QFileInfo(damaged).size() - 1));
+    QVERIFY(binary.open(damaged));
+    QVERIFY(!binary.verifyChecksum());
+    QVERIFY(!binary.isOpen());
+    QVERIFY(!binary.open(damaged, BinaryCatalog::FullCheck));
+    QVERIFY(flipByte(offsetof(BinaryCatalog::Header, courseCount)));
+    QVERIFY(!binary.open(damaged));
+
+    const auto mapped = parser.openBinaryCatalog(json);
+    QVERIFY(mapped != nullptr);
+    const QList<Course> fromMapped = materialize(CourseCatalog(mapped));
+    QVERIFY2(difference(courses, fromMapped).isEmpty(), qPrintable(difference(courses, fromMapped)));
+    const QList<Course> viaCache = parser.parseCourseJson(json);
+    QVERIFY2(difference(courses, viaCache).isEmpty(), qPrintable(difference(courses, viaCache)));
+    const CourseCatalog cached = parser.loadCourseCatalog(json);
+    const QList<Course> fromCatalog = materialize(cached);
+    QVERIFY2(difference(courses, fromCatalog).isEmpty(), qPrintable(difference(courses, fromCatalog)));
+    {
+        QFile file(json);
+        QVERIFY(file.open(QIODevice::Append));
+        file.write("\n");
+    }
+    QVERIFY(parser.openBinaryCatalog(json) == nullptr);
+}
+
+// 时间互不冲突、学分充足时，任意顺序的增量选课 / 退课都应与按同一选课集合整体重排一致。
+// 两条路径的总学分目标停止规则相同：目标为 0（界面默认）时只排选中的课程，
+// 目标较小时高优先级的未选课程只排到达标为止
+void CourseSelTests::incrementalMatchesRegenerate() {
+    QList<Course> courses;
+    for (int i = 0; i < 14; ++i) {
+        QStringList pre;
+        if (i >= 4) pre << QString("C%1").arg(i - 4, 2, 10, QChar('0'));
+        if (i % 5 == 3 && i >= 6) pre << QString("C%1").arg(i - 6, 2, 10, QChar('0'));
+        courses.append(makeCourse(QString("C%1").arg(i, 2, 10, QChar('0')), 2, i % 5, 1u << (i / 5), pre));
+    }
+    const int picked = courses.size();   // 只对前 picked 门课程选课 / 退课
+    // 无先修、不参与选课的高优先级课程，凭优先级成为候选，受总学分目标约束
+    for (int i = 0; i < 3; ++i)
+        courses.append(makeCourse(QString("P%1").arg(i), 2, i, 1u << 4));
+
+    for (int target : {0, 3, 1000}) {
+        auto configure = [&courses, target](ScheduleManager& m) {
+            for (const Course& c : courses) m.setPriority(c.id, c.id.startsWith('P') ? 9 : 0);
+            for (int s = 0; s < 8; ++s) m.setCreditLimit(s, 30);
+            m.setCreditTarget(target);
+        };
+
+        ScheduleManager incremental(courses);
+        configure(incremental);
+        incremental.generateSchedule();
+        QSet<QString> selected;
+        QRandomGenerator rng(17);
+        for (int step = 0; step < 300; ++step) {
+            const QString id = courses[rng.bounded(picked)].id;
+            if (selected.contains(id)) {
+                selected.remove(id);
+                QVERIFY(incremental.retractCourse(id));
+            } else {
+                selected.insert(id);
+                incremental.insertCourse(id);
+            }
+            ScheduleManager full(courses);
+            configure(full);
+            full.setSelectedCourses(selected);
+            full.generateSchedule();
+            QCOMPARE(semestersOf(incremental), semestersOf(full));
+            const QStringList ids = semestersOf(full).keys();
+            const auto byPriority = std::count_if(ids.begin(), ids.end(), [](const QString& id) {
+                return id.startsWith('P');
+            });
+            QCOMPARE(int(byPriority), target == 0 ? 0 : target == 3 ? 2 : 3);
+        }
+    }
+}
+
+// 有冲突与学分限制时增量结果未必与整体重排相同，但每一步都须合法：
+// 选课只增不挪，退课只移出该课程及其后续课程，insertCourse 的返回值与课程是否排入一致
+void CourseSelTests::incrementalKeepsScheduleValid() {
+    ScheduleManager m(real);
+    for (const Course& c : real) m.setPriority(c.id, 0);
+    for (int s = 0; s < 8; ++s) m.setCreditLimit(s, 12);
+    m.setCreditTarget(80);
+    m.generateSchedule();
+    ScheduleValidator validator(m.getCatalog());
+
+    QSet<QString> selected;
+    QRandomGenerator rng(23);
+    for (int step = 0; step < 400; ++step) {
+        const QString id = real[rng.bounded(int(real.size()))].id;
+        const QMap<QString, int> before = semestersOf(m);
+        if (selected.contains(id)) {
+            selected.remove(id);
+            QVERIFY(m.retractCourse(id));
+            const QList<QString> dependents = m.getDependentCourses(id);
+            const QMap<QString, int> after = semestersOf(m);
+            QVERIFY(!after.contains(id));
+            for (auto it = before.constBegin(); it != before.constEnd(); ++it) {
+                if (it.key() == id || dependents.contains(it.key())) continue;
+                QCOMPARE(after.value(it.key(), -1), it.value());
+            }
+        } else {
+            selected.insert(id);
+            const bool placed = m.insertCourse(id);
+            const QMap<QString, int> after = semestersOf(m);
+            QCOMPARE(placed, after.contains(id));
+            for (auto it = before.constBegin(); it != before.constEnd(); ++it)
+                QCOMPARE(after.value(it.key(), -1), it.value());
+        }
+        const ValidationResult r = validator.validate(m.getAllScheduled());
+        QVERIFY2(r.isValid(), qPrintable(r.errors.join("; ")));
+        for (int s = 0; s < 8; ++s) QVERIFY(m.getCreditSum(s) <= 12);
+    }
+}
+
+// 倒排位图给出的空闲班次应与逐个班次调用 conflicts / intersects 的结果完全相同
+void CourseSelTests::freeOfferingsMatchConflicts() {
+    QList<Course> courses = synthesizeCatalog(profile, 3000, 5);
+    QRandomGenerator rng(9);
+    for (Course& c : courses) {
+        for (CourseOffering& o : c.offerings) {
+            const int r = rng.bounded(6);
+            o.weeks = r == 0 ? 0u : r == 1 ? CourseOffering::AllWeeks : r == 2 ? 0x5555u
+                    : r == 3 ? 0xAAAAu : rng.generate();
+        }
+    }
+    const CourseCatalog cat(courses);
+    const SlotIndex index(cat);
+    for (int round = 0; round < 200; ++round) {
+        WeekOccupancy occupied;
+        SlotMask blocked;
+        const int k = rng.bounded(16);
+        for (int j = 0; j < k; ++j) {
+            const int o = rng.bounded(cat.offeringCount());
+            if (!occupied.conflicts(cat.offeringMask(o), cat.offeringWeeks(o)))
+                occupied.add(cat.offeringMask(o), cat.offeringWeeks(o));
+        }
+        if (rng.bounded(2) == 0) blocked.day[rng.bounded(7)] = quint16(rng.bounded(1 << 13));
+
+        QVector<int> expected;
+        for (int o = 0; o < cat.offeringCount(); ++o) {
+            if (!cat.offeringMask(o).intersects(blocked) &&
+                !occupied.conflicts(cat.offeringMask(o), cat.offeringWeeks(o)))
+                expected.append(o);
+        }
+        QCOMPARE(index.freeOfferings(occupied, blocked, cat), expected);
+    }
+}
+
+// 闭包的先修 / 后续课程表与链深度应与沿先修边的遍历一致，含成环与未知先修课程
+void CourseSelTests::closureMatchesGraphWalk() {
+    QList<Course> courses = synthesizeCatalog(profile, 2000, 7);
+    courses[3].prerequisites.append(courses[4].id);
+    courses[4].prerequisites.append(courses[3].id);
+    courses[5].prerequisites.append("NO-SUCH-COURSE");
+    courses[6].prerequisites.append(courses[3].id);
+    const CourseCatalog cat(courses);
+    const PrereqGraph graph(cat);
+    const PrereqClosure closure(graph);
+    QVERIFY(closure.isComplete());
+    const int n = cat.courseCount();
+
+    // 深度：无先修为 0，成环或依赖环为 -1
+    QVector<int> depth(n, -2);
+    QVector<bool> onPath(n, false);
+    std::function<int(int)> depthOf = [&](int c) {
+        if (depth[c] != -2) return depth[c];
+        if (onPath[c]) return -1;
+        onPath[c] = true;
+        int d = 0;
+        for (int p : graph.prerequisites(c)) {
+            const int x = depthOf(p);
+            if (x < 0) { d = -1; break; }
+            d = qMax(d, x + 1);
+        }
+        onPath[c] = false;
+        return depth[c] = d;
+    };
+
+    qsizetype pairs = 0;
+    QVector<QVector<int>> dependents(n);
+    for (int c = 0; c < n; ++c) {
+        QCOMPARE(closure.depth(c), depthOf(c));
+        QVector<int> ancestors;
+        if (depth[c] >= 0) {
+            QVector<bool> seen(n, false);
+            QVector<int> stack{c};
+            while (!stack.isEmpty()) {
+                for (int p : graph.prerequisites(stack.takeLast())) {
+                    if (seen[p]) continue;
+                    seen[p] = true;
+                    ancestors.append(p);
+                    stack.append(p);
+                }
+            }
+            std::sort(ancestors.begin(), ancestors.end());
+        }
+        const auto r = closure.ancestors(c);
+        QCOMPARE(QVector<int>(r.begin(), r.end()), ancestors);
+        for (int a : ancestors) {
+            QVERIFY(closure.dependsOn(graph, c, a));
+            dependents[a].append(c);
+        }
+        QVERIFY(!closure.dependsOn(graph, c, c));
+        pairs += ancestors.size();
+    }
+    for (int c = 0; c < n; ++c) {
+        const auto r = closure.descendants(c);
+        QCOMPARE(QVector<int>(r.begin(), r.end()), dependents[c]);
+    }
+    QCOMPARE(closure.pairCount(), pairs);
+}
+
+// 差异下限为 1 时依次给出的方案应恰好是全部可行方案按得分降序排列；
+// 下限更大时每个方案都应是与已给出方案都足够不同的方案中得分最高的
+void CourseSelTests::enumeratorMatchesBruteForce() {
+    for (quint32 seed = 1; seed <= 16; ++seed) {
+        for (int minDistance : {1, 2}) {
+            QRandomGenerator rng(seed);
+            Fixture f(real, 2, 8);
+            f.selectRandom(rng, 4);
+            const BruteForce brute(f.problem);
+
+            ScheduleEnumerator enumerator(f.problem, minDistance);
+            enumerator.setTimeBudget(60000);
+            QVector<ScheduleSolution> got;
+            std::set<PlanKey> seen;
+            ScheduleSolution s;
+            while (enumerator.next(s)) {
+                const PlanKey key = keyOf(s.placements);
+                QVERIFY(brute.plans.count(key) == 1);
+                QCOMPARE(s.score, brute.plans.at(key));
+                QVERIFY(seen.insert(key).second);
+                QVERIFY2(violation(f.problem, s).isEmpty(), qPrintable(violation(f.problem, s)));
+                got.append(s);
+            }
+
+            if (minDistance == 1) {
+                QVector<qint64> expected, scores;
+                for (const auto& kv : brute.plans) expected.append(kv.second);
+                std::sort(expected.begin(), expected.end(), std::greater<qint64>());
+                for (const auto& g : got) scores.append(g.score);
+                QCOMPARE(scores, expected);
+                continue;
+            }
+            QVector<ScheduleSolution> emitted;
+            for (int i = 0; i <= got.size(); ++i) {
+                qint64 best = -1;
+                for (const auto& kv : brute.plans) {
+                    QVector<Placement> plan;
+                    for (const auto& t : kv.first)
+                        plan.append(Placement{std::get<0>(t), std::get<1>(t), std::get<2>(t)});
+                    const bool farEnough = std::all_of(emitted.begin(), emitted.end(), [&](const ScheduleSolution& e) {
+                        return ScheduleEnumerator::distance(e.placements, plan) >= minDistance;
+                    });
+                    if (farEnough) best = qMax(best, kv.second);
+                }
+                if (i == got.size()) {
+                    QCOMPARE(best, qint64(-1));   // 没有遗漏的方案
+                } else {
+                    QCOMPARE(got[i].score, best);
+                    emitted.append(got[i]);
+                }
+            }
+        }
+    }
+}
+
+// 备选方案在当前方案的候选课程与学分内枚举：不论总学分目标为 0（只排手动选中的课程）、
+// 较小还是不设限，第一个备选方案都不差于界面上显示的方案，且学分不超过它；
+// 另设更低的总学分上限时以上限为准
+void CourseSelTests::alternativesStartFromCurrentPlan() {
+    for (quint32 seed = 1; seed <= 12; ++seed) {
+        QRandomGenerator rng(seed);
+        ScheduleManager m(real);
+        for (const Course& c : real) m.setPriority(c.id, rng.bounded(5));
+        QSet<QString> selected;
+        for (int i = 0; i < 5; ++i) {
+            const Course& c = real[rng.bounded(int(real.size()))];
+            selected.insert(c.id);
+            m.setPriority(c.id, 1 + rng.bounded(10));
+            for (const QString& pre : c.prerequisites) selected.insert(pre);
+        }
+        m.setSelectedCourses(selected);
+        for (int s = 0; s < 8; ++s) m.setCreditLimit(s, 6 + int(seed % 3) * 2);
+        const int targets[] = {0, 6, 1000};
+        m.setCreditTarget(targets[seed % 3]);
+        const int cap = seed % 4 == 0 ? 4 : 0;   // 贪心不看上限，当前方案可能越过它
+        m.setCreditCap(cap);
+        QCOMPARE(m.makeProblem().creditCap, cap);
+
+        QVERIFY(!m.makeAlternativeSnapshot());   // 尚未生成方案
+        m.generateSchedule();
+        const ScheduleSolution shown = m.getLastSolution();
+        const auto snapshot = m.makeAlternativeSnapshot();
+        if (shown.placements.isEmpty()) {
+            QVERIFY(!snapshot);
+            continue;
+        }
+        QVERIFY(snapshot);
+        QCOMPARE(snapshot->problem.creditCap, cap > 0 ? qMin(cap, shown.credits) : shown.credits);
+
+        ScheduleEnumerator enumerator(snapshot->problem, 1);
+        enumerator.setTimeBudget(60000);
+        ScheduleSolution first;
+        QVERIFY(enumerator.next(first));
+        QVERIFY2(violation(snapshot->problem, first).isEmpty(), qPrintable(violation(snapshot->problem, first)));
+        QVERIFY(first.optimal);
+        QVERIFY(first.credits <= snapshot->problem.creditCap);
+        if (snapshot->problem.creditCap < shown.credits) continue;
+        QVERIFY2(first.score >= shown.score, qPrintable(QString("%1 < %2").arg(first.score).arg(shown.score)));
+    }
+}
+
+// 局部搜索在小的步数预算内：以贪心方案为起点，报告的每个改进都是合法方案，
+// 改进曲线严格上升，结果不差于贪心；同一种子重复求解得到相同的方案与曲线
+void CourseSelTests::localSearchImprovesOnGreedy() {
+    struct Recorder : SolveMonitor {
+        QVector<ScheduleSolution> improvements;
+        bool isCanceled() const override { return false; }
+        void progress(int) override {}
+        void improved(const ScheduleSolution& best) override { improvements.append(best); }
+    };
+    const qint64 moveBudget = 20000;
+    for (quint32 seed = 1; seed <= 12; ++seed) {
+        QRandomGenerator rng(seed);
+        Fixture f(real, 3, 8 + int(seed % 3) * 2);
+        f.selectRandom(rng, 10);
+        if (seed % 3 == 0) f.problem.creditCap = 16;
+        if (seed % 2 == 0) f.problem.creditTarget = 10;
+
+        ScheduleSolution greedy;
+        QVERIFY(GreedySolver().solve(f.problem, greedy));
+        // 贪心起点已超出 creditCap 时局部搜索以起点为准
+        ScheduleProblem legal = f.problem;
+        if (legal.creditCap > 0) legal.creditCap = qMax(legal.creditCap, greedy.credits);
+
+        Recorder recorder;
+        f.problem.monitor = &recorder;
+        LocalSearchSolver solver(60000);
+        solver.setMoveBudget(moveBudget);
+        solver.setSeed(seed);
+        ScheduleSolution out;
+        QVERIFY(solver.solve(f.problem, out));
+        f.problem.monitor = nullptr;
+        QVERIFY2(violation(legal, out).isEmpty(), qPrintable(violation(legal, out)));
+        QVERIFY(out.score >= greedy.score);
+        QVERIFY(out.nodes <= moveBudget);
+
+        const QVector<ImprovementPoint> curve = solver.improvements();
+        QVERIFY(!curve.isEmpty());
+        QCOMPARE(curve.first().score, greedy.score);
+        QCOMPARE(curve.last().score, out.score);
+        for (int i = 1; i < curve.size(); ++i) {
+            QVERIFY(curve[i].score > curve[i - 1].score);
+            QVERIFY(curve[i].moves > curve[i - 1].moves);
+            QVERIFY(curve[i].ms >= curve[i - 1].ms);
+        }
+        // 起点得分为 0 时不报告，其余曲线上的点都经 improved 报告
+        const int skipped = greedy.score > 0 ? 0 : 1;
+        QCOMPARE(recorder.improvements.size(), curve.size() - skipped);
+        for (int i = 0; i < recorder.improvements.size(); ++i) {
+            const ScheduleSolution& s = recorder.improvements[i];
+            QVERIFY2(violation(legal, s).isEmpty(), qPrintable(violation(legal, s)));
+            QCOMPARE(s.score, curve[i + skipped].score);
+        }
+
+        LocalSearchSolver again(60000);
+        again.setMoveBudget(moveBudget);
+        again.setSeed(seed);
+        ScheduleSolution repeat;
+        QVERIFY(again.solve(f.problem, repeat));
+        QVERIFY(keyOf(repeat.placements) == keyOf(out.placements));
+        QCOMPARE(repeat.score, out.score);
+        QCOMPARE(repeat.nodes, out.nodes);
+        QCOMPARE(again.improvements().size(), curve.size());
+        for (int i = 0; i < curve.size(); ++i) {
+            QCOMPARE(again.improvements()[i].score, curve[i].score);
+            QCOMPARE(again.improvements()[i].moves, curve[i].moves);
+        }
+    }
+}
+
+// 检索结果应与逐门课程对名称、课程ID、教师做折叠大小写的子串判断一致：
+// 单字、双字与更长的中文关键词，大小写混合的拉丁字母，多个关键词，以及跨字段的假匹配
+void CourseSelTests::searchIndexMatchesContains() {
+    QList<Course> courses = real;
+    const QStringList latin = {"MaTH0001AbC", "math0002xyz", "CS-101a", "Cs-102B"};
+    for (int i = 0; i < latin.size(); ++i) {
+        Course c = makeCourse(latin[i], 2, i % 5, 1u << i);
+        c.name = i % 2 ? "Linear Algebra（荣誉）" : "Machine LEARNING 导论";
+        c.offerings[0].teacher = i % 2 ? "McDonald教授" : "O'Brien";
+        courses.append(c);
+    }
+    const CourseCatalog catalog(courses);
+    const CourseSearchIndex index(catalog);
+    QCOMPARE(index.courseCount(), catalog.courseCount());
+
+    QVector<QStringList> fields(catalog.courseCount());
+    for (int c = 0; c < catalog.courseCount(); ++c) {
+        fields[c] << catalog.courseName(c) << catalog.courseId(c);
+        for (int o = catalog.offeringBegin(c); o < catalog.offeringEnd(c); ++o)
+            fields[c] << catalog.offeringTeacher(o);
+    }
+    auto expected = [&](const QString& query) {
+        const QStringList terms = query.simplified().toCaseFolded().split(' ', Qt::SkipEmptyParts);
+        QVector<int> out;
+        if (terms.isEmpty()) return out;
+        for (int c = 0; c < catalog.courseCount(); ++c) {
+            const bool all = std::all_of(terms.begin(), terms.end(), [&](const QString& t) {
+                return std::any_of(fields[c].begin(), fields[c].end(), [&](const QString& f) {
+                    return f.toCaseFolded().contains(t);
+                });
+            });
+            if (all) out.append(c);
+        }
+        return out;
+    };
+
+    QStringList queries = {
+        "", "   ", "体", "语", "英语", "体育", "赛事英语", "体育赛事英语", "计算机", "副教授",
+        "（高级）", "c++", "C++", "coms", "COMS003113", "cOmS0031132104", "math", "MATH000",
+        "abc", "XYZ", "cs-10", "learning", "mcdonald", "o'brien", "英语 王", "计算机 副教授 李",
+        "coms 视觉", "  体育   英语  ", "machine 导论 o'b", "不存在的课程", "qq", "语c", "语\nc",
+    };
+    // 随机取各字段的子串，随机改变拉丁字母的大小写，并组合成多关键词查询
+    QRandomGenerator rng(29);
+    auto sample = [&]() {
+        const QStringList& f = fields[rng.bounded(int(fields.size()))];
+        const QString& s = f[rng.bounded(int(f.size()))];
+        const int len = 1 + rng.bounded(qMin(5, int(s.size())));
+        QString t = s.mid(rng.bounded(int(s.size()) - len + 1), len);
+        for (QChar& ch : t) {
+            if (rng.bounded(2)) ch = ch.isUpper() ? ch.toLower() : ch.toUpper();
+        }
+        return t;
+    };
+    for (int i = 0; i < 400; ++i) {
+        QString q = sample();
+        for (int k = rng.bounded(3); k > 0; --k) q += ' ' + sample();
+        queries << q;
+    }
+
+    for (const QString& q : queries) {
+        const QVector<int> got = index.search(q);
+        QVERIFY2(got == expected(q), qPrintable(QString("查询 \"%1\"").arg(q)));
+    }
+}
+
+// 校验器的各类错误：未知课程或班号、重复课程、先修课缺失或未排在更早的学期、
+// 时间冲突（每对冲突课程报告一次，周次不相交的不算冲突）；run() 中格式错误的文档只影响自己
+void CourseSelTests::validatorReportsErrors() {
+    QList<Course> courses;
+    courses << makeCourse("A", 2, 0, 0x3) << makeCourse("B", 3, 1, 0x1, {"A"})
+            << makeCourse("C", 2, 0, 0x2) << makeCourse("G", 2, 0, 0x3)
+            << makeCourse("D", 1, 2, 0x1) << makeCourse("E", 1, 2, 0x1)
+            << makeCourse("F", 1, 3, 0x1, {"GHOST"});
+    courses[4].offerings[0].weeks = 0x5555;   // D 单周、E 双周
+    courses[5].offerings[0].weeks = 0xAAAA;
+    const CourseCatalog catalog(courses);
+    ScheduleValidator validator(catalog);
+
+    // 错误条数与 fragments 一致，且依次包含对应片段
+    auto check = [&validator](const QList<ScheduledCourse>& schedule, const QStringList& fragments) {
+        const ValidationResult r = validator.validate(schedule);
+        if (r.errors.size() != fragments.size()) return r.errors.join("; ");
+        for (int i = 0; i < fragments.size(); ++i) {
+            if (!r.errors[i].contains(fragments[i])) return r.errors.join("; ");
+        }
+        return QString();
+    };
+    const QList<QPair<QList<ScheduledCourse>, QStringList>> cases = {
+        {{{"A", "01", 0}, {"B", "01", 1}, {"C", "01", -1}}, {}},
+        {{{"NOPE", "01", 0}}, {"课程 NOPE 不存在于课程目录"}},
+        {{{"A", "99", 0}}, {"班号 99 不在 offerings 中"}},
+        {{{"A", "01", 0}, {"A", "01", 1}, {"A", "01", 2}}, {"A（A） 重复出现"}},
+        {{{"B", "01", 1}}, {"B（B） 缺少先修课 A（A）"}},
+        {{{"A", "01", 1}, {"B", "01", 1}}, {"先修课 A（A） 学期 1 需早于本课学期 1"}},
+        {{{"B", "01", 1}, {"A", "01", 2}}, {"先修课 A（A） 学期 2 需早于本课学期 1"}},
+        {{{"F", "01", 0}}, {"F（F） 缺少先修课 GHOST"}},
+        {{{"D", "01", 0}, {"E", "01", 0}}, {}},
+        {{{"A", "01", 0}, {"C", "01", 0}, {"B", "01", 1}, {"D", "01", 1}}, {"学期 0 内 A（A） 与 C（C） 时间冲突"}},
+        {{{"A", "01", 0}, {"C", "01", 0}, {"G", "01", 0}},
+         {"A（A） 与 C（C）", "A（A） 与 G（G）", "C（C） 与 G（G）"}},
+    };
+    for (const auto& c : cases)
+        QVERIFY2(check(c.first, c.second).isEmpty(), qPrintable(check(c.first, c.second)));
+    QCOMPARE(validator.validate(cases[0].first).credits, 5);
+    QCOMPARE(validator.validate(cases[1].first).credits, 0);
+
+    // 跨越多个分块的一批文档：格式错误的记为一条错误，其余与逐份 validate 一致
+    QVector<QByteArray> documents;
+    for (int i = 0; i < 150; ++i) {
+        switch (i % 5) {
+        case 0: documents.append("[{\"course_id\": \"A\", \"class_id\": \"01\", \"semester\": 0}]"); break;
+        case 1: documents.append(QString("{\"student_id\": \"s%1\", \"schedule\": [{\"id\": \"A\", \"class\": \"01\", \"semester\": 0},"
+                                         " {\"id\": \"C\", \"class\": \"01\", \"semester\": 0}]}").arg(i).toUtf8()); break;
+        case 2: documents.append("{not json"); break;
+        case 3: documents.append("[{\"course_id\": \"B\", \"class_id\": \"01\", \"semester\": 1}"); break;
+        default: documents.append(""); break;
+        }
+    }
+    validator.setThreadCount(2);
+    const QVector<ValidationResult> results = validator.run(documents);
+    QCOMPARE(results.size(), documents.size());
+    for (int i = 0; i < documents.size(); ++i) {
+        const ValidationResult& r = results[i];
+        switch (i % 5) {
+        case 0:
+            QVERIFY(r.isValid());
+            QCOMPARE(r.credits, 2);
+            break;
+        case 1:
+            QCOMPARE(r.studentId, QString("s%1").arg(i));
+            QCOMPARE(r.errors.size(), qsizetype(1));
+            QVERIFY(r.errors[0].contains("时间冲突"));
+            break;
+        default:
+            QCOMPARE(r.errors, QStringList{"排课方案格式错误"});
+            QVERIFY(r.studentId.isEmpty());
+            QCOMPARE(r.credits, 0);
+            break;
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(CourseSelTests)
+#include "coursesel_tests.moc"
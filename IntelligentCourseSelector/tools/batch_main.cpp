@@ -0,0 +1,115 @@
+// batch_main.cpp
+// 无界面的批量排课工具（仅依赖 Qt Core）：
+//   coursesel_batch --catalog course.json --requests students.jsonl [--output plans.jsonl]
+//                   [--solver greedy|exact|local] [--budget ms] [--threads n]
+// 每行输入一个学生请求，按输入顺序每行输出一个排课结果，最后打印吞吐量
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include "batchplanner.h"
+#include "jsonparser.h"
+#include "schedule.h"
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("coursesel_batch");
+
+    QCommandLineParser cli;
+    cli.setApplicationDescription("批量为学生生成排课方案");
+    cli.addHelpOption();
+    QCommandLineOption catalogOpt("catalog", "课程目录 JSON 文件", "file");
+    QCommandLineOption requestsOpt("requests", "学生请求 JSONL 文件", "file");
+    QCommandLineOption outputOpt("output", "结果 JSONL 文件（默认标准输出）", "file");
+    QCommandLineOption solverOpt("solver", "求解器：greedy、exact 或 local（贪心后局部搜索）", "name", "greedy");
+    QCommandLineOption budgetOpt("budget", "exact / local 求解器每个学生的时间预算（毫秒）", "ms", "200");
+    QCommandLineOption threadsOpt("threads", "工作线程数，0 表示全部核心", "n", "0");
+    cli.addOptions({catalogOpt, requestsOpt, outputOpt, solverOpt, budgetOpt, threadsOpt});
+    cli.process(app);
+
+    QTextStream err(stderr);
+    if (!cli.isSet(catalogOpt) || !cli.isSet(requestsOpt)) {
+        err << "必须同时指定 --catalog 与 --requests" << Qt::endl;
+        return 1;
+    }
+    const QString solverName = cli.value(solverOpt);
+    if (solverName != "greedy" && solverName != "exact" && solverName != "local") {
+        err << "未知的求解器：" << solverName << Qt::endl;
+        return 1;
+    }
+
+    // 有最新的 .cscat（coursesel_compile 生成）时直接在映射内存上建目录
+    JsonParser parser;
+    const QString catalogPath = cli.value(catalogOpt);
+    CourseCatalog catalog = parser.loadCourseCatalog(catalogPath);
+    if (catalog.courseCount() == 0) {
+        err << "无法加载课程文件：" << catalogPath << Qt::endl;
+        return 1;
+    }
+
+    QFile reqFile(cli.value(requestsOpt));
+    if (!reqFile.open(QIODevice::ReadOnly)) {
+        err << "无法打开请求文件：" << reqFile.fileName() << Qt::endl;
+        return 1;
+    }
+    QVector<PlanRequest> requests;
+    QVector<int> lineNumbers;
+    int lineNo = 0;
+    while (!reqFile.atEnd()) {
+        const QByteArray line = reqFile.readLine().trimmed();
+        ++lineNo;
+        if (line.isEmpty()) continue;
+        PlanRequest req;
+        if (!BatchPlanner::parseRequest(line, req)) {
+            err << "跳过第 " << lineNo << " 行" << Qt::endl;
+            continue;
+        }
+        requests.append(req);
+        lineNumbers.append(lineNo);
+    }
+    reqFile.close();
+
+    QFile outFile;
+    if (cli.isSet(outputOpt)) {
+        outFile.setFileName(cli.value(outputOpt));
+        if (!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "无法写入结果文件：" << outFile.fileName() << Qt::endl;
+            return 1;
+        }
+    } else if (!outFile.open(stdout, QIODevice::WriteOnly)) {
+        err << "无法写入标准输出" << Qt::endl;
+        return 1;
+    }
+
+    ScheduleManager base(std::move(catalog));
+    BatchPlanner planner(base);
+    planner.setEngine(solverName == "exact"   ? BatchPlanner::Engine::BranchBound
+                      : solverName == "local" ? BatchPlanner::Engine::LocalSearch
+                                              : BatchPlanner::Engine::Greedy);
+    planner.setTimeBudget(cli.value(budgetOpt).toInt());
+    planner.setThreadCount(cli.value(threadsOpt).toInt());
+
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<PlanResult> results = planner.run(requests);
+    const qint64 solveMs = timer.elapsed();
+
+    int failed = 0;
+    for (int i = 0; i < results.size(); ++i) {
+        if (!results[i].error.isEmpty()) {
+            err << "第 " << lineNumbers[i] << " 行（" << results[i].studentId << "）："
+                << results[i].error << Qt::endl;
+            ++failed;
+        }
+        outFile.write(BatchPlanner::resultToJson(results[i]));
+        outFile.write("\n");
+    }
+    outFile.close();
+
+    const double seconds = qMax<qint64>(solveMs, 1) / 1000.0;
+    err << "学生数 " << results.size() << "，失败 " << failed
+        << "，求解耗时 " << solveMs << " ms，吞吐量 "
+        << QString::number(results.size() / seconds, 'f', 1) << " 人/秒" << Qt::endl;
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,187 @@
+// validate_main.cpp
+// 无界面的排课方案校验工具（仅依赖 Qt Core），替代逐对比较的 data/checker.cpp：
+//   coursesel_validate --catalog course.json [--output report.jsonl] [--threads n]
+//                      [--quiet] input...
+// input 可以是目录（其中每个 .json 文件是一份 schedule.json）、JSONL 文件（每行一份方案，
+// 如 coursesel_batch 的输出），或 - 表示从标准输入读取 JSONL。
+// 输入按批读取并在全部核心上并行校验，不合法的方案逐条打印，最后打印吞吐量
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include "jsonparser.h"
+#include "schedulevalidator.h"
+
+namespace {
+
+// 每批方案数：限制同时驻留的文档，同时让每批足够分给所有线程
+constexpr int BatchSize = 4096;
+
+struct Summary {
+    int total = 0;
+    int invalid = 0;
+    qint64 validateNs = 0;
+};
+
+class BatchRunner {
+public:
+    BatchRunner(const ScheduleValidator& validator, QFile* report, bool quiet)
+        : validator(validator), report(report), quiet(quiet) {}
+
+    // label 为方案未给出 student_id 时使用的名称（文件名或“文件:行号”）
+    void add(const QByteArray& document, const QString& label) {
+        documents.append(document);
+        labels.append(label);
+        if (documents.size() >= BatchSize) flush();
+    }
+
+    void flush() {
+        if (documents.isEmpty()) return;
+        QElapsedTimer timer;
+        timer.start();
+        QVector<ValidationResult> results = validator.run(documents);
+        summary.validateNs += timer.nsecsElapsed();
+
+        QTextStream out(stdout);
+        for (int i = 0; i < results.size(); ++i) {
+            ValidationResult& r = results[i];
+            if (r.studentId.isEmpty()) r.studentId = labels[i];
+            ++summary.total;
+            if (!r.isValid()) {
+                ++summary.invalid;
+                if (!quiet) {
+                    out << "✘ " << r.studentId << "（总学分 " << r.credits << "）：" << Qt::endl;
+                    for (const QString& e : r.errors)
+                        out << "  - " << e << Qt::endl;
+                }
+            }
+            if (report) {
+                report->write(ScheduleValidator::resultToJson(r));
+                report->write("\n");
+            }
+        }
+        documents.clear();
+        labels.clear();
+    }
+
+    const Summary& result() const { return summary; }
+
+private:
+    const ScheduleValidator& validator;
+    QFile* report;
+    bool quiet;
+    QVector<QByteArray> documents;
+    QStringList labels;
+    Summary summary;
+};
+
+bool readJsonl(QIODevice& device, const QString& name, BatchRunner& runner) {
+    int lineNo = 0;
+    while (!device.atEnd()) {
+        const QByteArray line = device.readLine().trimmed();
+        ++lineNo;
+        if (!line.isEmpty()) runner.add(line, QString("%1:%2").arg(name).arg(lineNo));
+    }
+    return true;
+}
+
+bool readInput(const QString& input, BatchRunner& runner, QTextStream& err) {
+    if (input == "-") {
+        QFile in;
+        if (!in.open(stdin, QIODevice::ReadOnly)) {
+            err << "无法读取标准输入" << Qt::endl;
+            return false;
+        }
+        return readJsonl(in, "stdin", runner);
+    }
+    const QFileInfo info(input);
+    if (info.isDir()) {
+        const QDir dir(input);
+        for (const QString& name : dir.entryList({"*.json"}, QDir::Files, QDir::Name)) {
+            QFile file(dir.filePath(name));
+            if (!file.open(QIODevice::ReadOnly)) {
+                err << "无法打开方案文件：" << file.fileName() << Qt::endl;
+                return false;
+            }
+            runner.add(file.readAll(), QFileInfo(name).completeBaseName());
+        }
+        return true;
+    }
+    QFile file(input);
+    if (!file.open(QIODevice::ReadOnly)) {
+        err << "无法打开方案文件：" << input << Qt::endl;
+        return false;
+    }
+    if (info.suffix() == "json") {
+        runner.add(file.readAll(), info.completeBaseName());
+        return true;
+    }
+    return readJsonl(file, info.fileName(), runner);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("coursesel_validate");
+
+    QCommandLineParser cli;
+    cli.setApplicationDescription("批量校验学生排课方案");
+    cli.addHelpOption();
+    cli.addPositionalArgument("input", "方案目录、JSONL 文件或 -（标准输入）", "input...");
+    QCommandLineOption catalogOpt("catalog", "课程目录 JSON 文件", "file");
+    QCommandLineOption outputOpt("output", "逐条校验结果 JSONL 文件", "file");
+    QCommandLineOption threadsOpt("threads", "工作线程数，0 表示全部核心", "n", "0");
+    QCommandLineOption quietOpt("quiet", "不逐条打印不合法的方案");
+    cli.addOptions({catalogOpt, outputOpt, threadsOpt, quietOpt});
+    cli.process(app);
+
+    QTextStream err(stderr);
+    const QStringList inputs = cli.positionalArguments();
+    if (!cli.isSet(catalogOpt) || inputs.isEmpty()) {
+        err << "必须指定 --catalog 与至少一个输入" << Qt::endl;
+        return 1;
+    }
+
+    // 有最新的 .cscat（coursesel_compile 生成）时直接在映射内存上建目录
+    JsonParser parser;
+    const QString catalogPath = cli.value(catalogOpt);
+    const CourseCatalog catalog = parser.loadCourseCatalog(catalogPath);
+    if (catalog.courseCount() == 0) {
+        err << "无法加载课程文件：" << catalogPath << Qt::endl;
+        return 1;
+    }
+
+    QFile report;
+    if (cli.isSet(outputOpt)) {
+        report.setFileName(cli.value(outputOpt));
+        if (!report.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "无法写入结果文件：" << report.fileName() << Qt::endl;
+            return 1;
+        }
+    }
+
+    ScheduleValidator validator(catalog);
+    validator.setThreadCount(cli.value(threadsOpt).toInt());
+    BatchRunner runner(validator, report.isOpen() ? &report : nullptr, cli.isSet(quietOpt));
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const QString& input : inputs) {
+        if (!readInput(input, runner, err)) return 1;
+    }
+    runner.flush();
+    const qint64 totalMs = timer.elapsed();
+    if (report.isOpen()) report.close();
+
+    // 吞吐量只计解析与校验（并行部分），总耗时另含读取输入与输出
+    const Summary& s = runner.result();
+    const double seconds = qMax<qint64>(s.validateNs, 1) / 1e9;
+    err << "方案数 " << s.total << "，不合法 " << s.invalid << "，校验耗时 "
+        << s.validateNs / 1000000 << " ms（总耗时 " << totalMs << " ms），吞吐量 "
+        << QString::number(s.total / seconds, 'f', 1) << " 份/秒" << Qt::endl;
+    return s.invalid == 0 ? 0 : 2;
+}